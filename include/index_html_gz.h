@@ -0,0 +1,211 @@
+
+    // AUTO GENERATED FILE, DO NOT EDIT
+    // gzip-compressed web/index.html, made by web_gz_pre.py
+    #ifndef INDEX_HTML_GZ_H
+    #define INDEX_HTML_GZ_H
+    #define INDEX_HTML_GZ_ETAG "\"16da4114\""
+    const uint8_t index_html_gz[3211] PROGMEM = {
+    0x1F,0x8B,0x08,0x00,0x00,0x00,0x00,0x00,0x02,0x03,0xAD,0x5A,0x7B,0x73,0xDB,0x36,
+    0x12,0xFF,0x3F,0x9F,0x02,0x61,0xC7,0x89,0x54,0xD3,0x94,0xEC,0xC4,0xBE,0x54,0x96,
+    0x7C,0xD3,0x73,0xD3,0x4B,0x6E,0xEA,0x36,0x57,0x3B,0x77,0xD3,0xC9,0x79,0x7A,0x14,
+    0x09,0x89,0x68,0x28,0x92,0x25,0x21,0x4B,0xEA,0xE3,0xBB,0xDF,0x6F,0x17,0x00,0x5F,
+    0x92,0x73,0x37,0x9D,0xB3,0x67,0x2C,0x00,0xBB,0x58,0x2C,0x76,0x17,0xFB,0x92,0xA7,
+    0x4F,0xBF,0xFA,0xEE,0xFA,0xEE,0x87,0x77,0xAF,0xC5,0x9B,0xBB,0x9B,0x6F,0xAE,0xA6,
+    0x89,0x5E,0xA5,0x57,0x4F,0xA6,0x4F,0x4F,0x4E,0x9E,0x08,0x71,0xAB,0x43,0xAD,0x22,
+    0x51,0x25,0x32,0x4D,0x45,0xBE,0x10,0x3A,0x91,0x62,0x23,0xE7,0xE2,0xFD,0xDB,0x40,
+    0xDC,0x25,0xAA,0x12,0x0B,0x95,0x4A,0x81,0xCF,0xE5,0x2F,0xAA,0x38,0x89,0xF2,0x55,
+    0x51,0xCA,0xAA,0x92,0xB1,0x08,0xB5,0x98,0xAF,0x55,0x1A,0x0B,0xAD,0x56,0x52,0xCC,
+    0x77,0xA0,0x85,0x7D,0x3F,0x2E,0x7F,0xF9,0x11,0x18,0x41,0xB1,0x13,0x61,0x16,0x8B,
+    0x4A,0x96,0x0F,0xC0,0x5D,0x94,0xF9,0x4A,0x2C,0xD2,0xB0,0x4A,0x7C,0x11,0xE2,0x9C,
+    0x38,0xD4,0x21,0xD1,0x5C,0x48,0x1D,0x25,0x44,0xAB,0x12,0x7F,0xBB,0xFD,0xEE,0xDB,
+    0xE0,0xC9,0xC9,0x09,0x18,0x4B,0x64,0x18,0x5F,0x81,0xDC,0x54,0x2B,0x9D,0xCA,0xAB,
+    0x9B,0xDD,0xAD,0xCC,0xAA,0xBC,0xAC,0xA6,0x23,0xB3,0x40,0xA0,0x95,0x04,0x85,0x28,
+    0x09,0xCB,0x4A,0xEA,0x99,0xB7,0xD6,0x8B,0x93,0x57,0x1E,0x03,0x2A,0xBD,0x33,0x28,
+    0x42,0xCC,0xF3,0x78,0x27,0x7E,0x15,0xF3,0x30,0xFA,0xB8,0x2C,0xF3,0x75,0x16,0x83,
+    0xFD,0x34,0x2F,0x27,0xE2,0xB3,0x88,0x7F,0x2E,0xC5,0x22,0xCF,0xF4,0xC9,0x22,0x5C,
+    0xA9,0x74,0x37,0x11,0x5F,0x96,0x2A,0x4C,0x7D,0xF1,0x46,0xA6,0x0F,0x12,0x22,0x09,
+    0x7D,0x71,0x1B,0x66,0xD5,0xC9,0xAD,0x2C,0xD5,0xE2,0x52,0x5C,0xDB,0xAD,0x63,0xFC,
+    0xBC,0x7A,0x75,0x29,0x52,0x95,0xC9,0x93,0x44,0xAA,0x65,0xA2,0x27,0xE2,0x34,0x38,
+    0xBD,0x14,0xBF,0xF3,0xA1,0x3A,0x9C,0x43,0x5E,0x38,0x35,0x2F,0x63,0x59,0xD2,0x89,
+    0x69,0x58,0x54,0x72,0x22,0xDC,0xA8,0x46,0x8C,0x81,0xA5,0xE5,0x56,0x9F,0x84,0xA9,
+    0x5A,0x66,0x13,0x51,0x12,0xAD,0x4B,0xBB,0x11,0x34,0x8B,0xAD,0xA8,0xF2,0x54,0xC5,
+    0xE2,0xB3,0x3F,0xF1,0xCF,0xA5,0x28,0xC2,0x38,0x56,0xD9,0x72,0x22,0x5E,0x16,0x5B,
+    0x47,0x66,0xBE,0xD6,0x3A,0xCF,0x40,0x6A,0x15,0x96,0x4B,0x05,0x32,0xE7,0x04,0x73,
+    0x98,0xA7,0x63,0x9A,0xAD,0x54,0xE6,0x58,0x3D,0xAB,0x17,0x36,0x2A,0xD6,0xC9,0x44,
+    0xBC,0xE2,0x85,0x45,0x9A,0x87,0x7A,0x92,0xCA,0x85,0x76,0x74,0x83,0x55,0x91,0x80,
+    0xAA,0x93,0xD8,0xC5,0x98,0x7E,0xAD,0xC4,0x2A,0xF5,0x8B,0x9C,0x54,0x2B,0x68,0x52,
+    0x96,0x35,0x7E,0xB5,0x8E,0x5A,0xF8,0x8B,0x68,0xFC,0x62,0x11,0x7D,0x0A,0x3F,0x2C,
+    0xDB,0xF8,0xE1,0xF8,0x1C,0x82,0xFD,0x14,0x7E,0xBE,0x58,0x1C,0x56,0xA6,0x1C,0x87,
+    0xF8,0xAD,0xF1,0x4A,0x59,0xF8,0x22,0x58,0x6E,0x80,0x1C,0xAB,0xAA,0x48,0x43,0xA8,
+    0x36,0xCB,0x33,0x2B,0xF7,0xE9,0xC8,0x1A,0xC8,0x74,0x64,0xCC,0x6C,0x4A,0x56,0xC2,
+    0x96,0x93,0x9C,0x09,0x15,0xCF,0x3C,0xB6,0x31,0xEF,0x0A,0xF0,0x33,0x5E,0x2E,0x8C,
+    0x31,0xBD,0x7D,0x37,0x99,0xCE,0x19,0x41,0x15,0x04,0x9D,0x5F,0x3D,0x93,0xAB,0xAA,
+    0xB8,0x64,0xE0,0xB7,0xE1,0x4A,0x3A,0x70,0x92,0x57,0x3A,0xC3,0x7C,0x0F,0xE9,0x3A,
+    0x09,0xB3,0x4C,0xA6,0x0E,0x2F,0x32,0xD3,0x3D,0xB4,0x77,0xF9,0x06,0xEA,0xB7,0x48,
+    0x05,0x4D,0xF6,0x50,0xA6,0x55,0x11,0x66,0x22,0xC2,0x7B,0xAA,0x66,0x1E,0xEE,0xEB,
+    0x19,0x16,0xC1,0x47,0x1E,0xD7,0x7C,0x64,0x18,0xAB,0x78,0x6F,0x2F,0x0E,0x08,0x4B,
+    0x99,0xE9,0xFA,0x04,0x9E,0xED,0x1F,0x31,0xA2,0x33,0x58,0x00,0xA3,0xA2,0x2D,0x87,
+    0x2F,0xBF,0xBF,0x16,0x76,0x2B,0x34,0x6E,0xF6,0x1D,0x09,0x0C,0x23,0xB8,0x05,0xDF,
+    0x81,0x8A,0x8F,0x96,0x24,0x2C,0x31,0xFA,0x28,0x75,0x03,0x29,0xA5,0x83,0x60,0x54,
+    0x2A,0x59,0xF9,0x4C,0xD6,0x4E,0x44,0x71,0x3E,0x1E,0x15,0x5F,0x9C,0x8F,0x56,0xE1,
+    0x76,0xE2,0xB6,0xC0,0x52,0xAC,0xC8,0x7D,0xF2,0x3A,0xA9,0x5A,0x29,0xDD,0x06,0x5A,
+    0x19,0x1E,0xD5,0xEC,0xF7,0x58,0xFE,0x3A,0x2F,0x37,0x61,0x49,0xEF,0x41,0xA4,0xA1,
+    0x96,0x59,0xB4,0x3B,0x78,0x0C,0x60,0x96,0xB3,0x55,0x65,0x24,0x6C,0x57,0x93,0xBC,
+    0xA8,0x08,0xC2,0x12,0x69,0xC9,0xC8,0x6A,0x10,0x4F,0xB0,0xDA,0xB1,0x47,0x92,0x25,
+    0x6F,0xA1,0xF9,0xCA,0xA3,0x47,0x36,0xF3,0xC6,0xF8,0x0C,0xB7,0x33,0xEF,0x74,0x8C,
+    0x51,0x9A,0x6F,0x66,0xDE,0x19,0x06,0x09,0xDE,0xE2,0xCC,0x3B,0x1F,0x13,0x55,0xDE,
+    0x67,0x18,0xC5,0x8E,0xB5,0x96,0xA3,0x24,0x5F,0x97,0xA3,0x98,0xEC,0xD6,0x72,0x46,
+    0x04,0x2D,0x6B,0x8F,0x5E,0x92,0x54,0x2F,0xCA,0x6D,0xAD,0xFD,0x72,0xEB,0x74,0x9A,
+    0x01,0x5F,0x37,0x00,0xDD,0x01,0xC8,0xB2,0xB6,0xB5,0x0C,0x63,0x7B,0xCA,0xC0,0x2E,
+    0xC9,0x12,0xF2,0xB2,0xD2,0x1D,0x3E,0x66,0x80,0xCB,0x4D,0x6D,0x7F,0x7F,0x05,0xFA,
+    0x86,0x18,0x6F,0x18,0x59,0x6E,0x1E,0xE3,0x64,0xB9,0x71,0xAC,0x7C,0xDA,0xE2,0x2A,
+    0x95,0x45,0x52,0xB4,0x35,0x52,0xE9,0x28,0x95,0x61,0x59,0xEB,0x04,0xFC,0xD6,0x50,
+    0xC9,0x4E,0x36,0xAE,0x61,0x6D,0xB6,0x39,0x52,0x21,0xEC,0x64,0xF9,0xA6,0x45,0x0F,
+    0xB3,0x1A,0x7B,0xFF,0xF4,0x34,0xCF,0x8B,0xC1,0x90,0x94,0xE8,0xF8,0xA6,0x15,0x4C,
+    0xED,0xA5,0x74,0xA2,0xE8,0x5A,0xCF,0x56,0x2A,0x2A,0xF3,0x4B,0xD8,0xF9,0x46,0xE9,
+    0x84,0x23,0x68,0x94,0x2A,0xBC,0xAC,0xAA,0xB7,0x2D,0xD1,0xBA,0x38,0xBC,0xB5,0xC5,
+    0x68,0x11,0x2E,0xA5,0x88,0x42,0xC4,0x46,0x98,0x4A,0x43,0x82,0x57,0x68,0xC1,0xD9,
+    0xA9,0x42,0x24,0xEE,0x42,0xCD,0x52,0x4B,0xAC,0x86,0x6A,0x19,0xC6,0x2A,0x17,0x3F,
+    0xAF,0xE5,0x5A,0x8A,0xB8,0xCC,0x8B,0x42,0xC6,0x6E,0xDB,0xCF,0x34,0x77,0x04,0xC3,
+    0xAD,0x88,0x65,0x81,0xB8,0x50,0x03,0x69,0xB6,0x47,0x4E,0xC5,0x69,0xED,0x67,0x68,
+    0x6C,0x4D,0xA4,0x85,0x31,0x0D,0x45,0x52,0xCA,0xC5,0xCC,0x1B,0x15,0x65,0x4E,0x29,
+    0x84,0x77,0x65,0x07,0xD3,0x51,0x78,0x75,0x10,0x31,0x2C,0x14,0xF9,0xE4,0x94,0xCE,
+    0x33,0x9F,0x3D,0xD4,0x6F,0xFF,0x71,0x8B,0x37,0x27,0xA3,0x8F,0x45,0xAE,0x5A,0x82,
+    0x8D,0x8A,0xCC,0x79,0x07,0xE2,0xBF,0x5E,0x7D,0x54,0x47,0xFB,0x4A,0xBE,0x7E,0xF7,
+    0x1E,0x8A,0x0E,0x63,0xB2,0x8C,0xD1,0xA9,0xC3,0x5F,0x51,0x38,0x6D,0xEC,0x24,0x2A,
+    0xD6,0x87,0xBC,0x80,0x0E,0xAB,0x8F,0x55,0x0F,0x8F,0xD7,0x0E,0x1B,0x15,0xB9,0xE5,
+    0x0A,0x89,0xD6,0x82,0x12,0x88,0xFA,0x85,0xDB,0xB9,0xE1,0xB7,0x41,0x9E,0x9A,0x6C,
+    0x82,0xC3,0x12,0x8D,0x08,0xCE,0x83,0x1A,0x67,0x91,0x97,0x2B,0x11,0x46,0x5A,0xE5,
+    0x70,0x36,0x23,0xF7,0x2C,0x6C,0x52,0xA0,0x77,0x85,0x24,0x37,0x3D,0x87,0xC3,0xF4,
+    0xAE,0xAE,0x09,0x08,0xFA,0x0C,0x03,0x01,0xDA,0x7A,0x80,0x46,0x29,0xE7,0x79,0xAE,
+    0x1F,0x23,0xF2,0xBD,0xAC,0x74,0x58,0xEA,0x43,0x64,0xAA,0xA8,0x54,0x85,0x36,0x02,
+    0x7D,0x08,0x4B,0x61,0x5F,0xA2,0x98,0x89,0xF1,0xE5,0x13,0x5E,0x5D,0xAC,0x33,0x3E,
+    0x05,0x69,0xA1,0x1E,0xA8,0xD8,0x7F,0x18,0x22,0x48,0x33,0xEA,0x2C,0xCE,0xA3,0xF5,
+    0x0A,0xCF,0x25,0x58,0x4A,0xFD,0x3A,0x95,0x34,0xFC,0xCB,0xEE,0x6D,0x0C,0xAC,0xE1,
+    0xA5,0x50,0x0B,0x31,0x90,0x43,0x21,0x03,0x4A,0x97,0xAE,0x91,0x21,0x00,0x3A,0x7B,
+    0x70,0x11,0xBF,0xA1,0x9A,0xE4,0x9B,0x41,0x94,0x56,0x44,0xB5,0xA6,0x07,0x9B,0x2F,
+    0x91,0x40,0xA6,0x32,0xD2,0x79,0xF9,0x65,0x9A,0x0E,0xBC,0xC0,0x3B,0x26,0xA4,0x00,
+    0x8C,0xBF,0xC6,0x93,0x19,0xB8,0xFD,0x74,0xC4,0xAF,0x38,0x84,0x13,0x84,0xC0,0xE6,
+    0x0E,0xB0,0xEF,0x8C,0x35,0x83,0xD3,0x86,0x7B,0x27,0x22,0xCD,0x1A,0x64,0xB4,0x0B,
+    0xE1,0x6B,0x5D,0x66,0x62,0x90,0x89,0xA9,0x38,0x1D,0x8B,0x3F,0x0B,0x72,0xFC,0x13,
+    0xE1,0x79,0x43,0x71,0x2C,0xB2,0xBD,0x7D,0x8B,0x95,0xBE,0x83,0x2F,0x1A,0x68,0xEC,
+    0xB5,0xAE,0x93,0xC4,0x40,0xB2,0xCA,0xE4,0x46,0x7C,0x05,0x37,0x3A,0xD0,0x9F,0x23,
+    0x66,0x8C,0x87,0x2E,0x6A,0xDB,0x13,0xE8,0xC4,0x98,0x84,0xF4,0xFE,0xEE,0x9A,0xD1,
+    0x86,0x74,0x02,0xEE,0x84,0xBF,0x6D,0xD8,0x0D,0xA4,0x94,0x0C,0x86,0xC7,0xA7,0x0D,
+    0xD8,0x81,0xBE,0x5E,0xA7,0xE9,0x0F,0x30,0x85,0x01,0x83,0xF0,0x6B,0x4F,0x10,0x3D,
+    0x12,0x6F,0x10,0x86,0x2A,0x4B,0x7F,0xB2,0x47,0x9F,0x43,0xD5,0xA3,0xE0,0x5B,0x19,
+    0xE5,0x59,0x4C,0x60,0xC3,0xFF,0xEF,0xC6,0x00,0x46,0x23,0x81,0x4C,0xCC,0xE6,0xC8,
+    0x25,0xBC,0x30,0x74,0x20,0x24,0x94,0x20,0x28,0xA7,0x2B,0xA8,0xFE,0x80,0xF4,0xE8,
+    0x89,0xC0,0xE6,0x2B,0xD4,0x22,0x08,0xF7,0x20,0xA4,0x43,0xBC,0x47,0xDE,0x09,0x84,
+    0x7F,0x03,0xF2,0xEF,0xAE,0x38,0x57,0xE1,0x47,0x79,0x47,0x34,0x61,0x2E,0x55,0x57,
+    0xA4,0x09,0x44,0xEA,0x4D,0x75,0x89,0xA7,0x94,0x5C,0xE1,0x19,0xE2,0xAF,0xE7,0x8B,
+    0xAD,0x4F,0xA7,0x57,0x80,0x7D,0xB8,0x77,0x02,0xC6,0xD6,0x7D,0x93,0x80,0xF9,0x59,
+    0x13,0xDD,0x01,0x19,0xB9,0xF8,0x09,0xFE,0x1C,0x9D,0x8E,0x8D,0x4D,0x12,0x8D,0x40,
+    0x65,0xB1,0xDC,0x7E,0xB7,0x18,0xEC,0x86,0xD0,0xFD,0x78,0xC8,0x84,0x83,0x62,0x5D,
+    0x25,0x58,0x61,0xA3,0x71,0x0A,0xA4,0x75,0x94,0x31,0xBA,0xA1,0x1E,0xFA,0xF3,0x96,
+    0xF1,0x84,0x27,0xF3,0x36,0x3E,0x89,0x66,0xB0,0x9D,0xE1,0xA8,0xED,0x94,0x0E,0xDC,
+    0x1E,0x1F,0x0F,0x71,0x9D,0x63,0xBE,0x4F,0x62,0xA3,0xE9,0x31,0x09,0x7E,0x4B,0x2A,
+    0x30,0x57,0x73,0x9B,0x2D,0xDE,0x08,0x17,0xF7,0x3A,0x0C,0xEC,0xDD,0x70,0xD7,0xC8,
+    0xAB,0xDE,0x66,0xC5,0x45,0xB4,0x77,0xAC,0xDE,0x2E,0xF1,0xFF,0xC2,0x5B,0x4C,0xFE,
+    0xEA,0x79,0x46,0xBB,0x07,0xBB,0xE3,0x2D,0x1B,0xC8,0x73,0x72,0x5C,0x71,0x9B,0xC4,
+    0x21,0x0E,0x9B,0xCB,0x3F,0xE6,0x0E,0xAC,0x1B,0x1C,0x42,0xEA,0x48,0x57,0xA8,0x9C,
+    0x85,0x5A,0x92,0xBE,0x8D,0x21,0x27,0x9C,0x88,0x0F,0xC8,0xF1,0x7C,0xE4,0x78,0x3E,
+    0xE2,0x80,0x1F,0xEA,0x6F,0x28,0x6B,0xBC,0x27,0x03,0xB2,0xA9,0xE6,0x9E,0x47,0xA2,
+    0x0C,0x8A,0xBC,0x12,0x92,0x17,0x5F,0x68,0x32,0x11,0x9B,0xA0,0x12,0xBD,0xAE,0x55,
+    0x45,0x38,0xF5,0x51,0x16,0x33,0xEF,0x18,0x66,0xE3,0x1B,0xD3,0xAB,0xEF,0x46,0xF6,
+    0xF2,0x14,0x64,0x8C,0xB2,0xDB,0xAB,0xE5,0x56,0x5C,0x91,0xE1,0xB4,0xD5,0x40,0xA2,
+    0x99,0xB3,0x02,0x4A,0xAB,0xDD,0x79,0x5B,0x78,0xEC,0x10,0xAD,0x7B,0xE5,0xBD,0x46,
+    0x9A,0xC6,0x26,0xDA,0xC9,0xD9,0x73,0x54,0x71,0xCF,0x99,0xCE,0x0D,0xF2,0xD8,0x00,
+    0x65,0x5E,0x5E,0xE2,0xC0,0xCF,0x5F,0x5C,0x8C,0xC7,0x23,0x4B,0x81,0x15,0x34,0x4A,
+    0x6C,0xB0,0x6A,0x94,0xD1,0x62,0x51,0x6F,0xDB,0xC7,0x4C,0xE7,0xE5,0xE8,0xAA,0x73,
+    0x0A,0xD2,0xFF,0xBD,0x53,0xE0,0xBD,0x3E,0xD7,0xDB,0x11,0xF6,0x1E,0x5B,0x41,0x1A,
+    0x5F,0x71,0xE4,0x0E,0x6A,0xB9,0x9D,0x03,0x24,0x21,0x73,0x43,0x12,0x83,0x0F,0xE3,
+    0x7B,0xE6,0xD1,0x4D,0x4F,0xBB,0xD3,0x33,0x9A,0x0E,0x68,0xF4,0xE2,0x9E,0x5C,0xAF,
+    0x70,0x80,0x17,0x8C,0x77,0xD4,0x78,0x62,0xAF,0x7F,0xC9,0xE8,0xD3,0x86,0xA4,0xF3,
+    0x3C,0xD5,0xAA,0x30,0x39,0x9D,0x2E,0xC3,0xC5,0x42,0x45,0x42,0x65,0xDC,0x24,0xA1,
+    0x34,0xD4,0x66,0xEC,0xD0,0x35,0x7C,0x25,0x37,0x3C,0x90,0xB6,0xBB,0xCD,0xA9,0x7A,
+    0x40,0x80,0xFF,0x80,0x78,0x09,0x0C,0x24,0x2C,0xB2,0x7C,0x08,0x53,0x9F,0x72,0xD0,
+    0x7C,0xAD,0xEF,0x7D,0xC1,0x00,0x31,0x9E,0x51,0x58,0xCE,0x50,0x9C,0xF8,0xE2,0x74,
+    0x96,0x73,0xB0,0xF1,0xC5,0xD9,0xCC,0x66,0x04,0x7B,0x56,0xFA,0x4F,0xF8,0x1B,0x3C,
+    0x64,0x36,0xD4,0x8D,0xCA,0x60,0x9C,0xAA,0xF4,0x45,0xBC,0x46,0xD1,0x4B,0x07,0xFE,
+    0x01,0x3B,0xD5,0x6C,0xA7,0xBE,0xA0,0xA2,0x95,0x5D,0xA2,0x67,0x6E,0xE5,0xF9,0x1E,
+    0x5D,0x0B,0x1F,0xB8,0x94,0x77,0xFF,0x69,0x43,0x8E,0x02,0xD6,0x1B,0x15,0xC2,0x20,
+    0x41,0x9C,0x88,0x67,0xCF,0xF8,0x93,0x94,0x37,0x9B,0x89,0x33,0xD2,0x0C,0x2E,0x65,
+    0x94,0xD1,0x26,0x76,0x08,0x79,0x08,0xAE,0xC8,0xD4,0xAC,0x14,0xFE,0x95,0x3D,0xBE,
+    0xE3,0xF4,0xDE,0x21,0xA3,0x12,0x86,0x7B,0xAD,0x84,0x7C,0x40,0xC8,0x67,0x23,0xB0,
+    0x08,0x1C,0xE7,0xAA,0x1E,0x11,0xC8,0x4D,0x3C,0xC5,0x59,0x6B,0xF8,0xEF,0x05,0xCE,
+    0x88,0x1D,0x19,0x00,0xB8,0x50,0xA8,0x12,0x94,0xC6,0x13,0xA6,0x43,0xC8,0xA3,0xD3,
+    0xF1,0x30,0xD0,0xF9,0xD7,0x6A,0x2B,0xE3,0x81,0x09,0xAB,0x47,0x3D,0x92,0xD0,0x82,
+    0x23,0x82,0x61,0xAA,0x22,0x28,0xB8,0x82,0xA0,0x22,0x09,0x3E,0x62,0x43,0x0A,0x00,
+    0xDA,0xDA,0xDB,0x09,0x4D,0x0E,0x49,0x9D,0xFB,0xFE,0x79,0xE3,0xAB,0xB6,0x6B,0x30,
+    0xD4,0xD9,0xF6,0x88,0x1A,0xEB,0xEC,0x83,0xE2,0x1B,0x52,0xD5,0xC5,0x8B,0x1B,0xFB,
+    0x5E,0xC8,0x8B,0xD9,0x05,0x96,0xC1,0x80,0x3F,0xE9,0x81,0x0C,0xCC,0xAA,0x7D,0x1F,
+    0xC3,0xD6,0x03,0x69,0xF1,0xD5,0x78,0xE3,0x28,0xE0,0xA6,0x08,0x14,0xAB,0x3B,0x2F,
+    0xA4,0x6D,0x97,0xD7,0xF9,0x9A,0x4C,0xBC,0x1A,0xB0,0x03,0x25,0xF7,0xD9,0xF1,0x9A,
+    0x4D,0x32,0x18,0x07,0x54,0x7E,0x9D,0xE0,0x93,0x6E,0xC1,0x49,0xA9,0x3B,0x87,0xD2,
+    0xC2,0x56,0x79,0xE7,0xD7,0x79,0x52,0x0B,0x77,0x38,0xEC,0x60,0x53,0xF1,0xD6,0xC6,
+    0xC3,0xBC,0x87,0xE1,0x0A,0x42,0xBF,0xED,0x9C,0xEC,0xE2,0xE8,0xD5,0xC5,0x4B,0xE4,
+    0x58,0x74,0xF1,0x58,0xF4,0xFC,0x97,0x43,0x21,0x57,0x39,0x3C,0x3A,0x7B,0x49,0x48,
+    0xC9,0x63,0x48,0x17,0x40,0xB9,0x18,0x13,0xCA,0xCA,0xEB,0x31,0x88,0xF2,0xD7,0x27,
+    0x81,0x04,0xE5,0x16,0xF9,0x80,0x59,0xD3,0x6E,0x4D,0x37,0x6B,0x54,0x7D,0x9B,0x45,
+    0x8C,0xB0,0xDA,0xB9,0x03,0xD7,0xE1,0x46,0xB0,0xD8,0x03,0x1D,0xF6,0x1C,0xAD,0xDB,
+    0x37,0x72,0x54,0xA1,0xD1,0x71,0x97,0x11,0x2E,0xC4,0xCD,0x01,0xCB,0xCD,0xF7,0xF5,
+    0xB9,0x5C,0x85,0xBB,0xE5,0xBB,0x6D,0x77,0x0F,0xB5,0x71,0x7C,0xE8,0x31,0xB0,0x5D,
+    0x1C,0xB7,0x89,0x9A,0x38,0xBC,0xEE,0x3C,0xBB,0x5D,0xA7,0x8E,0x10,0xAF,0xDB,0x7E,
+    0x50,0x97,0x1A,0xF7,0x71,0x0C,0xB9,0xF3,0x71,0xDB,0x83,0x07,0x08,0xD3,0x9D,0x39,
+    0x42,0xB6,0x23,0xC9,0xFD,0x1D,0xDE,0x64,0x63,0xF8,0xF0,0xB0,0x09,0x52,0xF9,0xF6,
+    0x36,0x5B,0xE4,0x83,0xC6,0xE6,0xB8,0xBB,0x3C,0x30,0x85,0xA5,0x02,0x08,0x69,0x03,
+    0x1C,0x77,0xD6,0xBC,0xAD,0xB2,0x95,0x7D,0x95,0xC1,0x4F,0x15,0x96,0x38,0x65,0xEB,
+    0xA1,0xC5,0xED,0x07,0x58,0xBB,0x53,0xF7,0x24,0x62,0x33,0x6A,0x82,0x33,0xB3,0x6D,
+    0xBA,0x88,0xBE,0x05,0xBA,0xCB,0xA8,0x82,0x96,0x54,0xE1,0xE6,0x75,0xAF,0x10,0xAB,
+    0x6E,0x3C,0xEC,0x51,0x72,0x7D,0x42,0xA0,0xD8,0xA1,0xDB,0x6D,0x9A,0x83,0x58,0xE7,
+    0x41,0x7F,0x9F,0xED,0xFF,0xF9,0xF4,0x26,0x62,0xF9,0x36,0xAE,0x77,0x99,0x86,0x1F,
+    0x6D,0xE3,0x51,0x7F,0x9F,0x6B,0x6F,0x00,0x81,0x86,0x37,0x8D,0x2A,0xDA,0x1D,0x8C,
+    0x06,0xFA,0x06,0xD3,0x3D,0x9E,0xEB,0x46,0x05,0x71,0x4D,0x93,0x37,0xAA,0xB1,0x9E,
+    0x76,0xA3,0xC2,0xC1,0x6F,0x78,0xDA,0xA7,0x63,0x7A,0x13,0xC0,0xE1,0xFE,0xC5,0xDF,
+    0xA9,0x7D,0x11,0xD8,0xF6,0x85,0x23,0x66,0x3B,0x14,0x5D,0x1C,0x70,0xF9,0x15,0x2D,
+    0xF7,0xE9,0x71,0xAF,0xC2,0x87,0x9B,0xA0,0x41,0xCF,0xA1,0xEF,0xDD,0x01,0xE5,0x3E,
+    0x02,0x6B,0x80,0xCF,0x20,0xCA,0x4B,0x59,0x81,0x6A,0xD1,0x18,0x45,0xC4,0x7E,0xB9,
+    0xA9,0x9D,0xEA,0x0A,0xCD,0x23,0x64,0xF6,0x13,0xCA,0x78,0x65,0x0E,0x20,0x94,0xC3,
+    0x1C,0x88,0x20,0x23,0x0B,0x3C,0x3D,0x04,0x3C,0xE2,0xA2,0x33,0xF8,0x29,0x57,0xD9,
+    0x00,0xAC,0x78,0x87,0x58,0x34,0x9D,0x06,0xC7,0x27,0xCF,0x82,0x85,0x4A,0xE1,0x89,
+    0x1B,0x56,0x75,0xCB,0xCC,0x35,0x65,0x4B,0xC8,0xE5,0x98,0x72,0xE7,0x42,0xFA,0xF0,
+    0x75,0xB4,0x0D,0x26,0xE6,0x1A,0xB4,0xFD,0x8F,0x71,0x9A,0x19,0x03,0xAE,0xBB,0x37,
+    0x41,0x56,0x9B,0x83,0x33,0xB7,0x36,0x14,0x4B,0xEF,0x3B,0xE6,0x40,0xB5,0x3D,0xAA,
+    0x4B,0xD3,0x60,0xA4,0x20,0xB6,0xDC,0x70,0xD8,0xA2,0xF6,0xF7,0xB0,0x1F,0xB2,0xFA,
+    0xCE,0x01,0xF1,0xE1,0xA6,0x1A,0xAC,0xAB,0x96,0x20,0xD6,0x15,0x97,0xEA,0xF4,0x03,
+    0x6A,0x83,0x96,0x3F,0x5D,0x57,0xB8,0xE1,0x78,0xD8,0xBF,0xE6,0x44,0xEC,0xE1,0x8C,
+    0xB9,0x23,0xB0,0xEF,0x87,0xE8,0x3B,0xB5,0xAA,0xE5,0x88,0xEC,0x91,0x6D,0x7F,0x44,
+    0xC9,0x5F,0xF5,0x7F,0x71,0x48,0xBD,0xD8,0x8B,0x77,0xC0,0xD1,0x37,0xA6,0x2F,0x58,
+    0xFA,0x6A,0x70,0x6D,0x26,0x02,0xDB,0x71,0x1F,0x85,0x7B,0xCD,0xBC,0xDD,0xA4,0x41,
+    0x01,0x2D,0x74,0x2D,0xA5,0x5D,0xB4,0x0E,0xE6,0x3D,0x39,0xB5,0x0C,0x61,0xD4,0xB1,
+    0x83,0x47,0xF3,0x50,0xD3,0x2E,0x1F,0x06,0xC8,0x8E,0xD7,0xC6,0xA1,0xB6,0x8F,0x36,
+    0xEF,0xA6,0xEF,0xA3,0x42,0x6D,0xA2,0x3E,0xB4,0x4A,0xB9,0x01,0x37,0xF5,0x29,0xAA,
+    0x34,0x8F,0x6A,0x0F,0xF8,0xC5,0xF9,0xE3,0x40,0x8A,0x37,0x2D,0x56,0xB9,0x71,0x90,
+    0x17,0x15,0x33,0xE3,0x70,0x68,0xA1,0x2B,0x87,0xE4,0x11,0x07,0xA0,0x73,0x7E,0x2C,
+    0x89,0x7D,0x39,0xC6,0x03,0x98,0x23,0x13,0x4E,0x57,0xBB,0x6C,0x24,0x78,0x53,0xFB,
+    0x6B,0x2F,0xEE,0x3B,0xDD,0x83,0xE6,0xE2,0xFC,0x6D,0x84,0xCF,0xFC,0x05,0xA9,0xCC,
+    0x96,0xA8,0x4C,0xEA,0x94,0x8E,0x17,0x9B,0x57,0x48,0x44,0x5D,0x72,0xD7,0x10,0x6A,
+    0xBA,0x25,0x26,0x34,0xF4,0x6E,0xD5,0xEE,0x67,0x65,0x70,0x94,0xC4,0x45,0x5B,0x8D,
+    0x76,0xCF,0x5E,0xA2,0xCA,0xFB,0x5C,0x19,0x4D,0x1B,0x51,0x51,0x04,0x54,0x4A,0x67,
+    0x81,0xE6,0xBF,0x75,0x39,0x9D,0x19,0xD3,0x6C,0x57,0x33,0x0E,0x9F,0x2B,0x9A,0x2C,
+    0xE0,0x9A,0x26,0x0B,0xB8,0xAA,0xC9,0x02,0xAE,0x6B,0xDA,0xC2,0xE8,0x3D,0xF3,0x26,
+    0xF4,0x9B,0x65,0xD0,0x7D,0x6B,0xCB,0xAD,0x81,0x83,0xF9,0xE2,0x62,0xDC,0xB4,0xD3,
+    0x5A,0x8F,0xB4,0xF7,0xB4,0x9A,0x97,0x45,0x8D,0xB8,0xD7,0x0F,0xB0,0xD2,0x5B,0x14,
+    0x41,0x91,0x84,0x39,0x4B,0x9A,0xD1,0xA3,0xCD,0x33,0x64,0xDD,0x15,0xF5,0xE8,0x67,
+    0xA2,0xE9,0x1E,0x3E,0xB4,0x5F,0xA5,0x6B,0xE7,0xF1,0xD7,0xDA,0x05,0x7D,0x4D,0x0D,
+    0x84,0x80,0xBE,0xF7,0xEE,0xAA,0xB4,0xF3,0x74,0x7D,0xF1,0xAB,0x4D,0xB4,0x26,0xFC,
+    0x7C,0x61,0x40,0x75,0x17,0xC2,0xAE,0x9C,0x52,0xE1,0x68,0x92,0x2B,0xBB,0x72,0x76,
+    0xEF,0xB7,0x6C,0x10,0x6F,0xC0,0xAE,0xBF,0x00,0x26,0x8C,0xDE,0xCE,0x5E,0xDE,0x73,
+    0x77,0xDC,0xCE,0xCE,0xEF,0xE9,0x9B,0x34,0x4E,0xA7,0xEC,0xCA,0xC5,0xFD,0xEF,0xBD,
+    0x07,0x80,0xFB,0xF3,0x77,0x4A,0xB8,0x62,0x98,0x56,0xF2,0x7F,0xB5,0x80,0x16,0x2F,
+    0x0D,0x05,0x37,0xFA,0xED,0x37,0xF1,0xF4,0x53,0xF5,0x68,0x86,0x1B,0xB7,0xD8,0x10,
+    0x8D,0x3D,0xB1,0x28,0x32,0xBE,0x7E,0x46,0x57,0xC6,0x5F,0xBA,0x60,0x16,0x54,0x28,
+    0xB3,0xE4,0xE0,0xE5,0xB0,0xC9,0x98,0x45,0xE7,0xD9,0x50,0x75,0x65,0x8F,0x1F,0xB6,
+    0xF5,0x7E,0x29,0x5C,0x8D,0xCF,0xCD,0xC8,0x24,0xA4,0xAF,0x85,0x44,0x44,0xFF,0x05,
+    0x41,0xDD,0x2D,0xA5,0xC5,0x4E,0x6A,0x67,0x6F,0xAD,0x34,0xB6,0x63,0x59,0x4C,0xAB,
+    0x6B,0x5A,0xE6,0xEC,0xE9,0xC8,0x75,0xC3,0xA7,0x23,0xF3,0x05,0xF3,0x74,0x64,0xFE,
+    0xED,0xE2,0x3F,0x14,0x41,0xDA,0x16,0x8D,0x21,0x00,0x00,
+    };
+    #endif
+    
\ No newline at end of file
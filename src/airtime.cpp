@@ -0,0 +1,209 @@
+/**
+ * @file 		  airtime.cpp
+ *
+ * Project		: Home automation
+ * Author		: Bernd Waldmann
+ * Created		: 16-Oct-2026
+ * Tabsize		: 4
+ *
+ * This Revision: $Id$
+ */
+
+/*
+   Copyright (C) 2024 Bernd Waldmann
+
+   This Source Code Form is subject to the terms of the Mozilla Public License, v. 2.0.
+   If a copy of the MPL was not distributed with this file, You can obtain one at http://mozilla.org/MPL/2.0/
+
+   SPDX-License-Identifier: MPL-2.0
+*/
+
+#include <esp_timer.h>
+#include "airtime.h"
+
+namespace airtime {
+
+/// size of MySensors header in front of payload
+const unsigned HEADER_BYTES = 7;
+/// packet control field of Enhanced ShockBurst, with dynamic payload length
+const unsigned PCF_BITS = 9;
+/// MySensors uses 16-bit CRC
+const unsigned CRC_BITS = 16;
+
+/// [ns] time per bit, from data rate
+static uint32_t nsPerBit = 4000;
+/// bits in a frame besides header and payload
+static uint32_t overheadBits = 8 + 5*8 + PCF_BITS + CRC_BITS;
+/// [us] an ACK frame without payload
+static uint32_t ackUs = (8 + 5*8 + PCF_BITS + CRC_BITS) * 4;
+
+/// duration of one bucket for each window, in seconds, same as in stats.cpp
+static const uint32_t bucketWidth[stats::NUM_WINDOWS] = {
+    60 / STATS_WINDOW_BUCKETS,
+    3600 / STATS_WINDOW_BUCKETS,
+    86400 / STATS_WINDOW_BUCKETS
+};
+
+/// [us] airtime in rolling windows
+static uint64_t buckets[stats::NUM_WINDOWS][STATS_WINDOW_BUCKETS];
+/// seconds since startup + 1 when buckets were last rotated, 0 if never
+static uint32_t lastRotate;
+/// [us] airtime per node since last clear
+static uint64_t nodeUs[256];
+static uint64_t totalUs;
+/// incremented whenever a counter changes
+static uint32_t nChanges;
+
+/// written by loop(), read by the HTTP task
+static portMUX_TYPE mux = portMUX_INITIALIZER_UNLOCKED;
+
+
+/**
+ * @brief Set radio parameters. Call before any packets are counted.
+ *
+ * @param kbps          data rate, 250, 1000 or 2000
+ * @param addressWidth  bytes, 3 to 5
+ */
+void begin( unsigned kbps, unsigned addressWidth )
+{
+    nsPerBit = 1000000uL / kbps;
+    // preamble is 2 bytes at 2 Mbps
+    unsigned preambleBits = (kbps >= 2000) ? 16 : 8;
+    overheadBits = preambleBits + addressWidth*8 + PCF_BITS + CRC_BITS;
+    ackUs = overheadBits * nsPerBit / 1000;
+}
+
+
+/**
+ * @brief Get time on air of one frame with `length` bytes of payload
+ */
+uint32_t frameUs( uint8_t length )
+{
+    return (overheadBits + 8 * (HEADER_BYTES + length)) * nsPerBit / 1000;
+}
+
+
+/**
+ * @brief Clear buckets that have expired since last rotation, call with `mux` held
+ */
+static void rotate( uint32_t now )
+{
+    if (lastRotate == now) return;
+    for (unsigned w=0; w<stats::NUM_WINDOWS; w++) {
+        uint32_t last = lastRotate / bucketWidth[w], cur = now / bucketWidth[w];
+        if (lastRotate == 0 || cur - last >= STATS_WINDOW_BUCKETS) {
+            memset( buckets[w], 0, sizeof buckets[w] );
+        } else {
+            for (uint32_t k=last+1; k<=cur; k++)
+                buckets[w][k % STATS_WINDOW_BUCKETS] = 0;
+        }
+    }
+    lastRotate = now;
+}
+
+
+static void count( uint8_t id, uint32_t us )
+{
+    uint32_t now = uint32_t(esp_timer_get_time() / 1000000) + 1;
+    portENTER_CRITICAL( &mux );
+    rotate( now );
+    for (unsigned w=0; w<stats::NUM_WINDOWS; w++)
+        buckets[w][(now / bucketWidth[w]) % STATS_WINDOW_BUCKETS] += us;
+    nodeUs[id] += us;
+    totalUs += us;
+    nChanges++;
+    portEXIT_CRITICAL( &mux );
+}
+
+
+/**
+ * @brief Count a frame received from `sender`.
+ *
+ * @param acked     false for broadcasts, which are not acknowledged
+ */
+void received( uint8_t sender, uint8_t length, bool acked )
+{
+    count( sender, frameUs(length) + (acked ? ackUs : 0) );
+}
+
+
+/**
+ * @brief Count a frame sent to `nextHop`, including retries.
+ *
+ * @param acked     false for broadcasts, which are not acknowledged
+ */
+void sent( uint8_t nextHop, uint8_t length, unsigned retries, bool acked )
+{
+    count( nextHop, (retries + 1) * frameUs(length) + (acked ? ackUs : 0) );
+}
+
+
+/**
+ * @brief Reset per-node counters. Rolling windows are not affected.
+ */
+void clear()
+{
+    portENTER_CRITICAL( &mux );
+    memset( nodeUs, 0, sizeof nodeUs );
+    totalUs = 0;
+    nChanges++;
+    portEXIT_CRITICAL( &mux );
+}
+
+
+/**
+ * @brief Get a number that changes whenever a packet is counted or counters
+ * are cleared, e.g. for an ETag
+ */
+uint32_t changes()
+{
+    return nChanges;
+}
+
+
+/**
+ * @brief Get share of time the channel was busy, in the last minute, hour and day
+ *
+ * @param permille  filled with 0...1000 for each window
+ */
+void utilization( uint16_t (&permille)[stats::NUM_WINDOWS] )
+{
+    uint64_t sum[stats::NUM_WINDOWS] = {};
+    uint32_t now = uint32_t(esp_timer_get_time() / 1000000) + 1;
+    portENTER_CRITICAL( &mux );
+    rotate( now );
+    for (unsigned w=0; w<stats::NUM_WINDOWS; w++)
+        for (uint64_t b : buckets[w]) sum[w] += b;
+    portEXIT_CRITICAL( &mux );
+    for (unsigned w=0; w<stats::NUM_WINDOWS; w++) {
+        uint64_t span = uint64_t(stats::windowSpan( stats::Window(w) )) * 1000000uLL;
+        uint64_t p = sum[w] * 1000 / span;
+        permille[w] = (p > 1000) ? 1000 : p;
+    }
+}
+
+
+/**
+ * @brief Get airtime of all nodes since last clear, in us
+ */
+uint64_t total()
+{
+    portENTER_CRITICAL( &mux );
+    uint64_t t = totalUs;
+    portEXIT_CRITICAL( &mux );
+    return t;
+}
+
+
+/**
+ * @brief Get airtime of packets from and to one node since last clear, in us
+ */
+uint64_t node( uint8_t id )
+{
+    portENTER_CRITICAL( &mux );
+    uint64_t t = nodeUs[id];
+    portEXIT_CRITICAL( &mux );
+    return t;
+}
+
+} // namespace airtime
@@ -0,0 +1,56 @@
+/**
+ * @file 		  airtime.h
+ *
+ * Project		: Home automation
+ * Author		: Bernd Waldmann
+ * Created		: 16-Oct-2026
+ * Tabsize		: 4
+ *
+ * This Revision: $Id$
+ */
+
+/*
+   Copyright (C) 2024 Bernd Waldmann
+
+   This Source Code Form is subject to the terms of the Mozilla Public License, v. 2.0.
+   If a copy of the MPL was not distributed with this file, You can obtain one at http://mozilla.org/MPL/2.0/
+
+   SPDX-License-Identifier: MPL-2.0
+*/
+
+/**
+ * @brief Estimate of time on air, from the packets this device sends and receives.
+ *
+ * An nRF24 Enhanced ShockBurst frame has preamble, address, packet control
+ * field, MySensors header and payload, and CRC. A send with `n` retries is
+ * n+1 frames, plus an ACK frame unless it was a broadcast. The time for
+ * this is computed from the configured data rate and added to a counter per
+ * node and to rolling minute/hour/day windows, in O(1) per packet.
+ *
+ * This is a lower bound: traffic between other nodes, frames that were lost
+ * before this device received them, and noise are not seen.
+ */
+
+#ifndef _airtime_h
+#define _airtime_h
+
+#include <Arduino.h>
+#include "stats.h"
+
+namespace airtime {
+
+void begin( unsigned kbps, unsigned addressWidth );
+uint32_t frameUs( uint8_t length );
+
+void received( uint8_t sender, uint8_t length, bool acked );
+void sent( uint8_t nextHop, uint8_t length, unsigned retries, bool acked );
+void clear();
+uint32_t changes();
+
+void utilization( uint16_t (&permille)[stats::NUM_WINDOWS] );
+uint64_t total();
+uint64_t node( uint8_t id );
+
+} // namespace airtime
+
+#endif // _airtime_h
@@ -0,0 +1,360 @@
+/**
+ * @file 		  cpuload.cpp
+ *
+ * Project		: Home automation
+ * Author		: Bernd Waldmann
+ * Created		: 16-Oct-2026
+ * Tabsize		: 4
+ *
+ * This Revision: $Id$
+ */
+
+/*
+   Copyright (C) 2024 Bernd Waldmann
+
+   This Source Code Form is subject to the terms of the Mozilla Public License, v. 2.0.
+   If a copy of the MPL was not distributed with this file, You can obtain one at http://mozilla.org/MPL/2.0/
+
+   SPDX-License-Identifier: MPL-2.0
+*/
+
+#include <esp_idf_version.h>
+#include <esp_freertos_hooks.h>
+#include "cpuload.h"
+
+#if !configUSE_TRACE_FACILITY
+ #error "cpuload needs configUSE_TRACE_FACILITY for uxTaskGetSystemState()"
+#endif
+
+#if ESP_IDF_VERSION >= ESP_IDF_VERSION_VAL(5,1,0)
+ #define idleTaskOfCore xTaskGetIdleTaskHandleForCore
+#else
+ #define idleTaskOfCore xTaskGetIdleTaskHandleForCPU
+#endif
+
+namespace cpuload {
+
+struct Core_t {
+    TaskHandle_t idleTask;
+    uint32_t total;         ///< run time or ticks, since startup
+    uint32_t idle;          ///< run time or ticks of the idle task, since startup
+    uint32_t lastTotal, lastIdle;
+    int32_t avgQ16;         ///< rolling average in 0.1% << 16
+    uint64_t periodBusy, periodTotal;
+    CoreLoad_t load;
+};
+
+/// one tracked task, free if handle is null
+struct Slot_t {
+    TaskHandle_t handle;
+    uint32_t count;         ///< run time or ticks, since startup
+    uint32_t last;          ///< count at previous `sample()`
+    bool claimed;           ///< claimed by this `sample()`, no interval measured yet
+    bool fresh;             ///< no loads computed yet
+    bool seen;              ///< still exists at this `sample()`
+    int32_t avgQ16;
+    uint64_t periodSum;
+    TaskLoad_t load;
+};
+
+static Core_t cores[portNUM_PROCESSORS];
+static Slot_t slots[CPULOAD_MAX_TASKS];
+/// time of one core since last `nextPeriod()`, in the units of `count`
+static uint64_t periodOneCore;
+
+/// written by the tick hooks and loop(), read by the HTTP task
+static portMUX_TYPE mux = portMUX_INITIALIZER_UNLOCKED;
+
+
+/**
+ * @brief Find the slot of a task. Call with mux held.
+ *
+ * @return Slot_t*  slot, or nullptr if task is not tracked
+ */
+static Slot_t* findSlot( TaskHandle_t h )
+{
+    for (Slot_t& s : slots)
+        if (s.handle == h) return &s;
+    return nullptr;
+}
+
+
+/**
+ * @brief Allocate a slot for a task. Call with mux held.
+ *
+ * @return Slot_t*  slot, or nullptr if all slots are in use
+ */
+static Slot_t* claimSlot( TaskHandle_t h )
+{
+    for (Slot_t& s : slots) {
+        if (s.handle) continue;
+        memset( &s, 0, sizeof s );
+        s.handle = h;
+        s.claimed = s.fresh = true;
+        return &s;
+    }
+    return nullptr;
+}
+
+
+#if !configGENERATE_RUN_TIME_STATS
+/// for the tick hook: handles of tracked tasks in ascending order, and their
+/// slot indices, so lookup is a binary search of at most log2(CPULOAD_MAX_TASKS) steps
+static TaskHandle_t sortedHandles[CPULOAD_MAX_TASKS];
+static uint8_t sortedSlots[CPULOAD_MAX_TASKS];
+static unsigned nSorted;
+
+
+/**
+ * @brief Fill the lookup table from the slots in use. Call with mux held.
+ */
+static void rebuildIndex()
+{
+    nSorted = 0;
+    for (unsigned i=0; i<CPULOAD_MAX_TASKS; i++) {
+        TaskHandle_t h = slots[i].handle;
+        if (!h) continue;
+        // insertion sort, at most CPULOAD_MAX_TASKS entries
+        unsigned k = nSorted++;
+        while (k > 0 && uintptr_t(sortedHandles[k-1]) > uintptr_t(h)) {
+            sortedHandles[k] = sortedHandles[k-1];
+            sortedSlots[k] = sortedSlots[k-1];
+            k--;
+        }
+        sortedHandles[k] = h;
+        sortedSlots[k] = uint8_t(i);
+    }
+}
+
+
+/**
+ * @brief Tick hook, called 1000 times per second on each core: count the 
+ * running task. Only looks up slots, they are claimed and freed in `sample()`,
+ * so a new task is counted from the `sample()` after it started.
+ */
+static IRAM_ATTR void onTick()
+{
+    Core_t& c = cores[xPortGetCoreID()];
+    TaskHandle_t h = xTaskGetCurrentTaskHandle();
+    portENTER_CRITICAL_ISR( &mux );
+    c.total++;
+    if (h == c.idleTask) c.idle++;
+    unsigned lo = 0, hi = nSorted;
+    while (lo < hi) {
+        unsigned mid = (lo + hi) / 2;
+        if (uintptr_t(sortedHandles[mid]) < uintptr_t(h)) lo = mid + 1; else hi = mid;
+    }
+    if (lo < nSorted && sortedHandles[lo] == h) slots[sortedSlots[lo]].count++;
+    portEXIT_CRITICAL_ISR( &mux );
+}
+#endif
+
+
+/**
+ * @brief Start measuring. Call from setup().
+ */
+void begin()
+{
+    for (unsigned i=0; i<portNUM_PROCESSORS; i++) {
+        cores[i].idleTask = idleTaskOfCore( i );
+#if !configGENERATE_RUN_TIME_STATS
+        if (esp_register_freertos_tick_hook_for_cpu( onTick, i ) != ESP_OK)
+            log_e("cannot register tick hook on core %u", i);
+#endif
+    }
+}
+
+
+static inline uint16_t permille( uint64_t part, uint64_t total )
+{
+    return total ? uint16_t(part * 1000 / total) : 0;
+}
+
+
+/// update rolling average with a new sample, return the average in 0.1%
+static uint16_t average( int32_t& avgQ16, uint16_t now, bool first )
+{
+    if (first)
+        avgQ16 = int32_t(now) << 16;
+    else
+        avgQ16 += ((int32_t(now) << 16) - avgQ16) / CPULOAD_AVG_SAMPLES;
+    return uint16_t((avgQ16 + 0x8000) >> 16);
+}
+
+
+/**
+ * @brief Compute loads since the previous call. Call once per second from loop().
+ */
+void sample()
+{
+    static TaskStatus_t status[CPULOAD_MAX_TASKS];
+    static int8_t affinity[CPULOAD_MAX_TASKS];
+    static bool first = true;
+    decltype(TaskStatus_t::ulRunTimeCounter) totalRunTime;
+
+    unsigned n = uxTaskGetSystemState( status, CPULOAD_MAX_TASKS, &totalRunTime );
+    if (n == 0) {
+        static bool warned = false;
+        if (!warned) {
+            log_e("more than %d tasks, CPU load is not measured", CPULOAD_MAX_TASKS);
+            warned = true;
+        }
+        return;
+    }
+    for (unsigned i=0; i<n; i++) {
+        BaseType_t a = xTaskGetAffinity( status[i].xHandle );
+        affinity[i] = (a == tskNO_AFFINITY) ? -1 : int8_t(a);
+    }
+
+    portENTER_CRITICAL( &mux );
+    for (Slot_t& s : slots) s.seen = false;
+    for (unsigned i=0; i<n; i++) {
+        Slot_t* s = findSlot( status[i].xHandle );
+        if (!s) {
+            s = claimSlot( status[i].xHandle );
+            if (!s) continue;
+            strlcpy( s->load.name, status[i].pcTaskName, sizeof s->load.name );
+            s->load.core = affinity[i];
+        }
+        s->seen = true;
+#if configGENERATE_RUN_TIME_STATS
+        s->count = uint32_t(status[i].ulRunTimeCounter);
+#endif
+    }
+
+    uint64_t oneCore = 0;
+    for (Core_t& c : cores) {
+#if configGENERATE_RUN_TIME_STATS
+        c.total = uint32_t(totalRunTime);
+        for (const Slot_t& s : slots)
+            if (s.handle == c.idleTask) c.idle = s.count;
+#endif
+        uint32_t total = c.total - c.lastTotal;
+        uint32_t idle = c.idle - c.lastIdle;
+        if (idle > total) idle = total;
+        c.lastTotal = c.total;
+        c.lastIdle = c.idle;
+        c.periodBusy += total - idle;
+        c.periodTotal += total;
+        oneCore += total;
+        CoreLoad_t& l = c.load;
+        l.now = permille( total - idle, total );
+        l.avg = average( c.avgQ16, l.now, first );
+        l.period = permille( c.periodBusy, c.periodTotal );
+        if (l.now > l.periodMax) l.periodMax = l.now;
+    }
+    oneCore /= portNUM_PROCESSORS;
+    periodOneCore += oneCore;
+
+    for (Slot_t& s : slots) {
+        if (!s.handle) continue;
+        if (!s.seen) {
+            s.handle = nullptr;     // task was deleted
+            continue;
+        }
+        uint32_t d = s.count - s.last;
+        s.last = s.count;
+        if (s.claimed) {
+            s.claimed = false;
+            continue;
+        }
+        s.periodSum += d;
+        TaskLoad_t& l = s.load;
+        l.now = permille( d, oneCore );
+        l.avg = average( s.avgQ16, l.now, s.fresh );
+        l.period = permille( s.periodSum, periodOneCore );
+        s.fresh = false;
+    }
+    first = false;
+#if !configGENERATE_RUN_TIME_STATS
+    rebuildIndex();
+#endif
+    portEXIT_CRITICAL( &mux );
+}
+
+
+/**
+ * @brief Start a new period for the period averages and maxima, e.g. after
+ * the hourly report
+ */
+void nextPeriod()
+{
+    portENTER_CRITICAL( &mux );
+    for (Core_t& c : cores) {
+        c.periodBusy = c.periodTotal = 0;
+        c.load.period = c.load.periodMax = 0;
+    }
+    for (Slot_t& s : slots) {
+        s.periodSum = 0;
+        s.load.period = 0;
+    }
+    periodOneCore = 0;
+    portEXIT_CRITICAL( &mux );
+}
+
+
+/**
+ * @brief Get number of CPU cores
+ */
+unsigned numCores()
+{
+    return portNUM_PROCESSORS;
+}
+
+
+/**
+ * @brief Get load of core `i`
+ */
+void core( unsigned i, CoreLoad_t& load )
+{
+    if (i >= portNUM_PROCESSORS) {
+        memset( &load, 0, sizeof load );
+        return;
+    }
+    portENTER_CRITICAL( &mux );
+    load = cores[i].load;
+    portEXIT_CRITICAL( &mux );
+}
+
+
+/**
+ * @brief Get CPU share of tasks, in descending order of the rolling average
+ *
+ * @param loads     array to be filled
+ * @param max       size of array
+ * @return unsigned number of entries filled in
+ */
+unsigned tasks( TaskLoad_t* loads, unsigned max )
+{
+    unsigned n = 0;
+    portENTER_CRITICAL( &mux );
+    for (const Slot_t& s : slots) {
+        if (!s.handle || s.fresh) continue;
+        // insertion sort, drop the smallest if array is full
+        unsigned i = n;
+        while (i > 0 && loads[i-1].avg < s.load.avg) {
+            if (i < max) loads[i] = loads[i-1];
+            i--;
+        }
+        if (i < max) loads[i] = s.load;
+        if (n < max) n++;
+    }
+    portEXIT_CRITICAL( &mux );
+    return n;
+}
+
+
+/**
+ * @brief Get name of measurement method, "runtime" for FreeRTOS run time
+ * counters or "tick" for sampling in the tick hook
+ */
+const char* method()
+{
+#if configGENERATE_RUN_TIME_STATS
+    return "runtime";
+#else
+    return "tick";
+#endif
+}
+
+} // namespace cpuload
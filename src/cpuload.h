@@ -0,0 +1,83 @@
+/**
+ * @file 		  cpuload.h
+ *
+ * Project		: Home automation
+ * Author		: Bernd Waldmann
+ * Created		: 16-Oct-2026
+ * Tabsize		: 4
+ *
+ * This Revision: $Id$
+ */
+
+/*
+   Copyright (C) 2024 Bernd Waldmann
+
+   This Source Code Form is subject to the terms of the Mozilla Public License, v. 2.0.
+   If a copy of the MPL was not distributed with this file, You can obtain one at http://mozilla.org/MPL/2.0/
+
+   SPDX-License-Identifier: MPL-2.0
+*/
+
+/**
+ * @brief CPU load per core and CPU share per FreeRTOS task.
+ *
+ * If FreeRTOS was built with `configGENERATE_RUN_TIME_STATS`, the run time
+ * counters of all tasks are used. Otherwise (the default for Arduino), a tick
+ * hook on each core samples which task is running, 1000 times per second.
+ * Sampling misses tasks that always run briefly right after a tick, so short
+ * tick-aligned activity is attributed to the idle task. The tick hook only
+ * counts, with a binary search for the running task; tasks are added and
+ * removed in `sample()`, so a new task is counted from the next second on.
+ *
+ * `sample()` should be called once per second; it computes the load during
+ * the last second, an exponential average over about `CPULOAD_AVG_SAMPLES`
+ * seconds, and the average since the last `nextPeriod()`. All loads are in
+ * 0.1% of one core, so a task not pinned to a core can show up to 2000.
+ */
+
+#ifndef _cpuload_h
+#define _cpuload_h
+
+#include <Arduino.h>
+
+/// max number of tasks that are tracked
+#ifndef CPULOAD_MAX_TASKS
+ #define CPULOAD_MAX_TASKS  32
+#endif
+
+/// time constant of the rolling average, in samples
+#ifndef CPULOAD_AVG_SAMPLES
+ #define CPULOAD_AVG_SAMPLES 60
+#endif
+
+namespace cpuload {
+
+/// load of one core, in 0.1%
+struct CoreLoad_t {
+    uint16_t now;           ///< during last sample interval
+    uint16_t avg;           ///< rolling average
+    uint16_t period;        ///< average since last `nextPeriod()`
+    uint16_t periodMax;     ///< highest `now` since last `nextPeriod()`
+};
+
+/// CPU share of one task, in 0.1% of one core
+struct TaskLoad_t {
+    char name[configMAX_TASK_NAME_LEN];
+    int8_t core;            ///< core the task is pinned to, or -1
+    uint16_t now;           ///< during last sample interval
+    uint16_t avg;           ///< rolling average
+    uint16_t period;        ///< average since last `nextPeriod()`
+};
+
+void begin();
+void sample();
+void nextPeriod();
+
+unsigned numCores();
+void core( unsigned i, CoreLoad_t& load );
+unsigned tasks( TaskLoad_t* loads, unsigned max );
+const char* method();
+
+} // namespace cpuload
+
+#endif // _cpuload_h
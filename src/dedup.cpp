@@ -0,0 +1,87 @@
+/**
+ * @file 		  dedup.cpp
+ *
+ * Project		: Home automation
+ * Author		: Bernd Waldmann
+ * Created		: 16-Oct-2026
+ * Tabsize		: 4
+ *
+ * This Revision: $Id$
+ */
+
+/*
+   Copyright (C) 2024 Bernd Waldmann
+
+   This Source Code Form is subject to the terms of the Mozilla Public License, v. 2.0.
+   If a copy of the MPL was not distributed with this file, You can obtain one at http://mozilla.org/MPL/2.0/
+
+   SPDX-License-Identifier: MPL-2.0
+*/
+
+#include "dedup.h"
+
+static_assert( (DEDUP_SLOTS & (DEDUP_SLOTS-1)) == 0, "DEDUP_SLOTS must be a power of 2" );
+
+namespace dedup {
+
+/// one recently received message
+struct Recent_t {
+    uint32_t hash;
+    uint32_t t_received;    ///< [us] low 32 bits of esp_timer_get_time()
+    bool used;
+};
+
+/// only used by loop(), needs no lock
+static Recent_t recent[DEDUP_SLOTS];
+
+
+static inline uint32_t fnv1a( uint32_t h, uint8_t b )
+{
+    return (h ^ b) * 16777619uL;
+}
+
+
+/**
+ * @brief Hash a message for `isDuplicate()`. Call from `previewMessage()`,
+ * while the payload is still available.
+ */
+uint32_t hash( uint8_t sender, uint8_t sensor, uint8_t command, uint8_t type,
+    const void* payload, uint8_t length )
+{
+    uint32_t h = 2166136261uL;
+    h = fnv1a( h, sender );
+    h = fnv1a( h, sensor );
+    h = fnv1a( h, command );
+    h = fnv1a( h, type );
+    h = fnv1a( h, length );
+    const uint8_t* p = (const uint8_t*)payload;
+    for (unsigned i=0; i<length; i++) h = fnv1a( h, p[i] );
+    return h;
+}
+
+
+/**
+ * @brief Check if a message was received shortly before, and remember it.
+ * For each received message, in order of arrival.
+ *
+ * The window starts at the first copy and is not extended by duplicates, so
+ * a node that sends the same payload periodically has one message counted
+ * per window at least.
+ *
+ * @param h     hash of message, from `hash()`
+ * @param now   [us] time of reception, low 32 bits of esp_timer_get_time()
+ * @return true if the first copy of the same message from the same sender 
+ * was received less than DEDUP_WINDOW_MS ago
+ */
+bool isDuplicate( uint32_t h, uint32_t now )
+{
+    Recent_t& r = recent[(h ^ (h >> 16)) & (DEDUP_SLOTS-1)];
+    if (r.used && r.hash == h && now - r.t_received < DEDUP_WINDOW_MS * 1000uL)
+        return true;
+    r.hash = h;
+    r.t_received = now;
+    r.used = true;
+    return false;
+}
+
+} // namespace dedup
@@ -0,0 +1,61 @@
+/**
+ * @file 		  dedup.h
+ *
+ * Project		: Home automation
+ * Author		: Bernd Waldmann
+ * Created		: 16-Oct-2026
+ * Tabsize		: 4
+ *
+ * This Revision: $Id$
+ */
+
+/*
+   Copyright (C) 2024 Bernd Waldmann
+
+   This Source Code Form is subject to the terms of the Mozilla Public License, v. 2.0.
+   If a copy of the MPL was not distributed with this file, You can obtain one at http://mozilla.org/MPL/2.0/
+
+   SPDX-License-Identifier: MPL-2.0
+*/
+
+/**
+ * @brief Detection of duplicate messages, as sent again by a node when the
+ * ACK for the first copy was lost.
+ *
+ * A 32-bit FNV-1a hash over sender, sensor, command, type and payload is
+ * looked up in a direct-mapped cache of DEDUP_SLOTS recent messages. A message
+ * is a duplicate if the first copy with the same hash was seen less than 
+ * DEDUP_WINDOW_MS ago.
+ * A collision in the cache only replaces the older entry, so a duplicate may
+ * be missed, but a message is never wrongly reported as duplicate unless
+ * two different messages have the same 32-bit hash.
+ *
+ * Cost per message is one hash over at most 32 bytes and one cache lookup.
+ */
+
+#ifndef _dedup_h
+#define _dedup_h
+
+#include <Arduino.h>
+
+/// number of recent messages remembered, must be a power of 2
+#ifndef DEDUP_SLOTS
+ #define DEDUP_SLOTS        64
+#endif
+
+/// [ms] copies of a message received within this time after the first are duplicates.
+/// Covers the 15 hardware retries of the nRF24 (up to 4 ms each) and a quick
+/// resend by the node, but not a node that sends the same value every second.
+#ifndef DEDUP_WINDOW_MS
+ #define DEDUP_WINDOW_MS    250
+#endif
+
+namespace dedup {
+
+uint32_t hash( uint8_t sender, uint8_t sensor, uint8_t command, uint8_t type,
+    const void* payload, uint8_t length );
+bool isDuplicate( uint32_t hash, uint32_t now );
+
+} // namespace dedup
+
+#endif // _dedup_h
@@ -0,0 +1,252 @@
+/**
+ * @file 		  health.cpp
+ *
+ * Project		: Home automation
+ * Author		: Bernd Waldmann
+ * Created		: 16-Oct-2026
+ * Tabsize		: 4
+ *
+ * This Revision: $Id$
+ */
+
+/*
+   Copyright (C) 2024 Bernd Waldmann
+
+   This Source Code Form is subject to the terms of the Mozilla Public License, v. 2.0.
+   If a copy of the MPL was not distributed with this file, You can obtain one at http://mozilla.org/MPL/2.0/
+
+   SPDX-License-Identifier: MPL-2.0
+*/
+
+#include <esp_heap_caps.h>
+#include "health.h"
+
+#if !configUSE_TRACE_FACILITY
+ #error "health needs configUSE_TRACE_FACILITY for uxTaskGetSystemState()"
+#endif
+
+namespace health {
+
+/// ring of heap samples, `nSamples` valid entries ending before `head`
+static HeapSample_t samples[HEALTH_HISTORY];
+static unsigned head, nSamples;
+
+/// stack high-water marks at last `sample()`
+static TaskStack_t taskStacks[HEALTH_MAX_TASKS];
+static unsigned nTasks;
+
+/// written by loop(), read by the HTTP task
+static portMUX_TYPE mux = portMUX_INITIALIZER_UNLOCKED;
+
+/// a task that was warned about, by handle and name, because a new task
+/// may get the handle of a deleted one
+struct Warned_t {
+    TaskHandle_t handle;
+    char name[configMAX_TASK_NAME_LEN];
+};
+
+/// tasks that were warned about and still exist, only used by loop()
+static Warned_t warnedTasks[HEALTH_MAX_TASKS];
+static unsigned nWarnedTasks;
+static bool heapWarned, fragmentationWarned;
+
+/// pending warnings, only used by loop()
+const unsigned MAX_WARNINGS = 8;
+static Warning_t warnings[MAX_WARNINGS];
+static unsigned nWarnings, firstWarning;
+/// warnings dropped because the queue was full, since startup and at last report
+static uint32_t nDropped, nDroppedReported;
+
+
+static void warn( Kind kind, bool cleared, uint32_t value, const char* task = "" )
+{
+    if (nWarnings == MAX_WARNINGS) {
+        nDropped++;
+        return;
+    }
+    Warning_t& w = warnings[(firstWarning + nWarnings++) % MAX_WARNINGS];
+    w.kind = kind;
+    w.cleared = cleared;
+    w.value = value;
+    strlcpy( w.task, task, sizeof w.task );
+}
+
+
+/// forget warned tasks that no longer exist
+static void pruneWarned( const TaskStatus_t* status, unsigned n )
+{
+    unsigned k = 0;
+    for (unsigned j=0; j<nWarnedTasks; j++) {
+        const Warned_t& t = warnedTasks[j];
+        for (unsigned i=0; i<n; i++) {
+            if (status[i].xHandle == t.handle && strcmp( status[i].pcTaskName, t.name ) == 0) {
+                warnedTasks[k++] = t;
+                break;
+            }
+        }
+    }
+    nWarnedTasks = k;
+}
+
+
+/// return true if task was already warned about, else remember it
+static bool alreadyWarned( const TaskStatus_t& st )
+{
+    for (unsigned j=0; j<nWarnedTasks; j++) {
+        const Warned_t& t = warnedTasks[j];
+        if (t.handle == st.xHandle && strcmp( t.name, st.pcTaskName ) == 0) return true;
+    }
+    // cannot be full, all entries are tasks in the current status
+    Warned_t& t = warnedTasks[nWarnedTasks++];
+    t.handle = st.xHandle;
+    strlcpy( t.name, st.pcTaskName, sizeof t.name );
+    return false;
+}
+
+
+/**
+ * @brief Take a sample of stack and heap metrics, and check thresholds.
+ * Call from loop(), e.g. once per minute.
+ */
+void sample( unsigned long t_now )
+{
+    static TaskStatus_t status[HEALTH_MAX_TASKS];
+    static TaskStack_t current[HEALTH_MAX_TASKS];
+
+    HeapSample_t s;
+    s.t = t_now / 1000;
+    s.free = heap_caps_get_free_size( MALLOC_CAP_8BIT );
+    s.largest = heap_caps_get_largest_free_block( MALLOC_CAP_8BIT );
+    s.minFree = heap_caps_get_minimum_free_size( MALLOC_CAP_8BIT );
+    // not read atomically, so largest block may exceed free heap meanwhile
+    s.fragmentation = (s.largest < s.free) ? uint16_t(1000 - uint64_t(s.largest) * 1000 / s.free) : 0;
+    s.minStack = UINT16_MAX;
+
+    // stack high-water marks are in bytes on ESP32
+    unsigned n = uxTaskGetSystemState( status, HEALTH_MAX_TASKS, nullptr );
+    if (n == 0) {
+        static bool warned = false;
+        if (!warned) {
+            log_e("more than %d tasks, stacks are not checked", HEALTH_MAX_TASKS);
+            warned = true;
+        }
+    } else {
+        pruneWarned( status, n );
+    }
+    for (unsigned i=0; i<n; i++) {
+        const TaskStatus_t& st = status[i];
+        uint32_t left = st.usStackHighWaterMark;
+        strlcpy( current[i].name, st.pcTaskName, sizeof current[i].name );
+        current[i].free = left;
+        if (left < s.minStack) s.minStack = uint16_t(left);
+        if (left < HEALTH_MIN_STACK && !alreadyWarned( st ))
+            warn( STACK, false, left, st.pcTaskName );
+    }
+
+    if (!heapWarned && s.free < HEALTH_MIN_FREE_HEAP) {
+        heapWarned = true;
+        warn( FREE_HEAP, false, s.free );
+    } else if (heapWarned && s.free > HEALTH_MIN_FREE_HEAP + HEALTH_MIN_FREE_HEAP / 4) {
+        heapWarned = false;
+        warn( FREE_HEAP, true, s.free );
+    }
+    if (!fragmentationWarned && s.fragmentation > HEALTH_MAX_FRAGMENTATION) {
+        fragmentationWarned = true;
+        warn( FRAGMENTATION, false, s.fragmentation );
+    } else if (fragmentationWarned && s.fragmentation < HEALTH_MAX_FRAGMENTATION * 4 / 5) {
+        fragmentationWarned = false;
+        warn( FRAGMENTATION, true, s.fragmentation );
+    }
+
+    portENTER_CRITICAL( &mux );
+    samples[head] = s;
+    head = (head + 1) % HEALTH_HISTORY;
+    if (nSamples < HEALTH_HISTORY) nSamples++;
+    if (n > 0) {    // 0 if there are more than HEALTH_MAX_TASKS tasks
+        memcpy( taskStacks, current, n * sizeof current[0] );
+        nTasks = n;
+    }
+    portEXIT_CRITICAL( &mux );
+}
+
+
+/**
+ * @brief Get next pending warning from `sample()`. If warnings were dropped
+ * because too many were pending, a DROPPED warning with their number follows.
+ *
+ * @return true if there was one
+ */
+bool nextWarning( Warning_t& w )
+{
+    if (nWarnings == 0) {
+        if (nDropped == nDroppedReported) return false;
+        w.kind = DROPPED;
+        w.cleared = false;
+        w.value = nDropped - nDroppedReported;
+        w.task[0] = '\0';
+        nDroppedReported = nDropped;
+        return true;
+    }
+    w = warnings[firstWarning];
+    firstWarning = (firstWarning + 1) % MAX_WARNINGS;
+    nWarnings--;
+    return true;
+}
+
+
+/**
+ * @brief Get number of warnings dropped since startup, because too many were pending
+ */
+uint32_t dropped()
+{
+    return nDropped;
+}
+
+
+/**
+ * @brief Get heap samples, oldest first
+ *
+ * @param out       array to be filled
+ * @param max       size of array
+ * @return unsigned number of samples filled in, the most recent ones
+ */
+unsigned history( HeapSample_t* out, unsigned max )
+{
+    portENTER_CRITICAL( &mux );
+    unsigned n = (max < nSamples) ? max : nSamples;
+    unsigned i = (head + HEALTH_HISTORY - n) % HEALTH_HISTORY;
+    for (unsigned k=0; k<n; k++, i = (i+1) % HEALTH_HISTORY)
+        out[k] = samples[i];
+    portEXIT_CRITICAL( &mux );
+    return n;
+}
+
+
+/**
+ * @brief Get stack high-water marks of all tasks at the last `sample()`,
+ * in ascending order, i.e. the task closest to overflow first
+ *
+ * @param tasks     array to be filled
+ * @param max       size of array
+ * @return unsigned number of entries filled in
+ */
+unsigned stacks( TaskStack_t* tasks, unsigned max )
+{
+    unsigned n = 0;
+    portENTER_CRITICAL( &mux );
+    for (unsigned k=0; k<nTasks; k++) {
+        const TaskStack_t& t = taskStacks[k];
+        // insertion sort, drop the largest if array is full
+        unsigned i = n;
+        while (i > 0 && tasks[i-1].free > t.free) {
+            if (i < max) tasks[i] = tasks[i-1];
+            i--;
+        }
+        if (i < max) tasks[i] = t;
+        if (n < max) n++;
+    }
+    portEXIT_CRITICAL( &mux );
+    return n;
+}
+
+} // namespace health
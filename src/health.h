@@ -0,0 +1,110 @@
+/**
+ * @file 		  health.h
+ *
+ * Project		: Home automation
+ * Author		: Bernd Waldmann
+ * Created		: 16-Oct-2026
+ * Tabsize		: 4
+ *
+ * This Revision: $Id$
+ */
+
+/*
+   Copyright (C) 2024 Bernd Waldmann
+
+   This Source Code Form is subject to the terms of the Mozilla Public License, v. 2.0.
+   If a copy of the MPL was not distributed with this file, You can obtain one at http://mozilla.org/MPL/2.0/
+
+   SPDX-License-Identifier: MPL-2.0
+*/
+
+/**
+ * @brief Stack and heap monitor, to catch slow degradation of a long-running gateway.
+ *
+ * `sample()` records the stack high-water mark of every task, and free heap,
+ * largest free block, minimum free heap ever, and fragmentation. Heap samples
+ * are kept in a ring of the last HEALTH_HISTORY samples.
+ *
+ * Fragmentation is 1 - largest free block / free heap, in 0.1%: 0 if all free
+ * memory is one block, close to 1000 if it is scattered in small pieces.
+ *
+ * When a task has less than HEALTH_MIN_STACK bytes of stack left, or heap
+ * crosses HEALTH_MIN_FREE_HEAP or HEALTH_MAX_FRAGMENTATION, a warning is
+ * returned by `nextWarning()`. Heap warnings are cleared with some hysteresis;
+ * stack high-water marks only go down, so each task is warned about once
+ * while it exists.
+ */
+
+#ifndef _health_h
+#define _health_h
+
+#include <Arduino.h>
+
+/// number of heap samples kept
+#ifndef HEALTH_HISTORY
+ #define HEALTH_HISTORY         60
+#endif
+
+/// max number of tasks that are checked
+#ifndef HEALTH_MAX_TASKS
+ #define HEALTH_MAX_TASKS       32
+#endif
+
+/// [bytes] warn if a task has less stack left than this
+#ifndef HEALTH_MIN_STACK
+ #define HEALTH_MIN_STACK       512
+#endif
+
+/// [bytes] warn if free heap drops below this
+#ifndef HEALTH_MIN_FREE_HEAP
+ #define HEALTH_MIN_FREE_HEAP   20000
+#endif
+
+/// [0.1%] warn if fragmentation rises above this
+#ifndef HEALTH_MAX_FRAGMENTATION
+ #define HEALTH_MAX_FRAGMENTATION 600
+#endif
+
+namespace health {
+
+/// one sample of heap metrics
+struct HeapSample_t {
+    uint32_t t;             ///< [s] since startup
+    uint32_t free;          ///< [bytes] free heap
+    uint32_t largest;       ///< [bytes] largest free block
+    uint32_t minFree;       ///< [bytes] lowest free heap since startup
+    uint16_t fragmentation; ///< [0.1%]
+    uint16_t minStack;      ///< [bytes] lowest stack high-water mark of all tasks
+};
+
+/// stack high-water mark of one task
+struct TaskStack_t {
+    char name[configMAX_TASK_NAME_LEN];
+    uint32_t free;          ///< [bytes] stack never used since task start
+};
+
+enum Kind : uint8_t {
+    STACK,                  ///< task has little stack left
+    FREE_HEAP,              ///< free heap is low
+    FRAGMENTATION,          ///< heap is fragmented
+    DROPPED                 ///< warnings were dropped, too many were pending
+};
+
+/// a threshold crossed, as returned by `nextWarning()`
+struct Warning_t {
+    Kind kind;
+    bool cleared;           ///< true if back to normal
+    uint32_t value;         ///< bytes for STACK and FREE_HEAP, 0.1% for FRAGMENTATION, count for DROPPED
+    char task[configMAX_TASK_NAME_LEN]; ///< for STACK
+};
+
+void sample( unsigned long t_now );
+bool nextWarning( Warning_t& w );
+uint32_t dropped();
+
+unsigned history( HeapSample_t* samples, unsigned max );
+unsigned stacks( TaskStack_t* tasks, unsigned max );
+
+} // namespace health
+
+#endif // _health_h
@@ -0,0 +1,180 @@
+/**
+ * @file 		  html_template.h
+ *
+ * Project		: Home automation
+ * Author		: Bernd Waldmann
+ * Created		: 16-Oct-2026
+ * Tabsize		: 4
+ *
+ * This Revision: $Id$
+ */
+
+/*
+   Copyright (C) 2024 Bernd Waldmann
+
+   This Source Code Form is subject to the terms of the Mozilla Public License, v. 2.0.
+   If a copy of the MPL was not distributed with this file, You can obtain one at http://mozilla.org/MPL/2.0/
+
+   SPDX-License-Identifier: MPL-2.0
+*/
+
+/**
+ * @brief Compile-time tokenizer for HTML templates with %KEYWORD% placeholders.
+ *
+ * The template is split into a constant table of literal segments and
+ * keyword references by the compiler, so rendering a page is a single
+ * linear pass over the table, without searching for '%' or copying
+ * substrings at run time.
+ *
+ * A keyword is enclosed in %...%, an empty keyword "%%" stands for a literal '%'.
+ * Keyword names are resolved to their index in a keyword list at compile time, 
+ * so the renderer can dispatch with a `switch` rather than comparing strings.
+ */
+
+#ifndef _html_template_h
+#define _html_template_h
+
+#include <stddef.h>
+#include <stdint.h>
+
+#define CHAR_BEGIN_VAR '%'
+#define CHAR_END_VAR '%'
+
+namespace tmpl {
+
+enum TokenKind : uint8_t {
+    LITERAL,    ///< text to be copied to the output as-is
+    KEYWORD     ///< name of a keyword, to be replaced by the processor
+};
+
+/// keyword id for names not found in the keyword list
+const uint8_t UNKNOWN_KEYWORD = 0xFF;
+
+/// one segment of a template, refers to a span of the template text
+struct Token {
+    uint16_t offset;    ///< start of text or keyword name within template
+    uint16_t length;    ///< length of text or keyword name
+    TokenKind kind;
+    uint8_t id;         ///< for KEYWORD: index into keyword list
+};
+
+/// table of tokens, as generated by `tokenize()`
+template<size_t NT>
+struct TokenTable {
+    Token tokens[NT];
+    constexpr size_t size() const { return NT; }
+    constexpr const Token* begin() const { return tokens; }
+    constexpr const Token* end() const { return tokens + NT; }
+};
+
+/// result of scanning one token: the token, and where the next one starts
+struct Scan {
+    Token token;
+    size_t next;
+};
+
+
+/**
+ * @brief Scan one token starting at position `p` of the template
+ */
+template<size_t N>
+constexpr Scan scanToken( const char (&tpl)[N], size_t p )
+{
+    const size_t len = N-1;
+    if (tpl[p] == CHAR_BEGIN_VAR) {
+        size_t q = p+1;
+        while (q < len && tpl[q] != CHAR_END_VAR) q++;
+        if (q == p+1)   // "%%" is a literal '%'
+            return Scan{ Token{ uint16_t(p), 1, LITERAL, 0 }, q+1 };
+        return Scan{ Token{ uint16_t(p+1), uint16_t(q-p-1), KEYWORD, 0 }, q+1 };
+    }
+    size_t q = p;
+    while (q < len && tpl[q] != CHAR_BEGIN_VAR) q++;
+    return Scan{ Token{ uint16_t(p), uint16_t(q-p), LITERAL, 0 }, q };
+}
+
+
+/**
+ * @brief Find a keyword name (not 0-terminated) in a keyword list
+ * 
+ * @return uint8_t  index into `keywords`, or UNKNOWN_KEYWORD
+ */
+template<size_t NK>
+constexpr uint8_t findKeyword( const char* name, size_t len, const char* const (&keywords)[NK] )
+{
+    for (size_t k=0; k<NK; k++) {
+        const char* kw = keywords[k];
+        size_t i = 0;
+        while (i < len && kw[i] == name[i]) i++;
+        if (i == len && kw[i] == '\0') return uint8_t(k);
+    }
+    return UNKNOWN_KEYWORD;
+}
+
+
+/**
+ * @brief Check that every %KEYWORD% is terminated, and that the template fits
+ * into the 16-bit offsets of a Token
+ */
+template<size_t N>
+constexpr bool isWellFormed( const char (&tpl)[N] )
+{
+    size_t nMarks = 0;
+    for (size_t p=0; p < N-1; p++)
+        if (tpl[p] == CHAR_BEGIN_VAR) nMarks++;
+    return (nMarks % 2 == 0) && (N <= UINT16_MAX);
+}
+
+
+/**
+ * @brief Check that all keywords used in a template are found in the keyword list
+ */
+template<size_t N, size_t NK>
+constexpr bool hasOnlyKeywords( const char (&tpl)[N], const char* const (&keywords)[NK] )
+{
+    static_assert( NK < UNKNOWN_KEYWORD, "too many keywords" );
+    for (size_t p=0; p < N-1; ) {
+        Scan s = scanToken(tpl,p);
+        if (s.token.kind == KEYWORD 
+            && findKeyword(tpl + s.token.offset, s.token.length, keywords) == UNKNOWN_KEYWORD)
+            return false;
+        p = s.next;
+    }
+    return true;
+}
+
+
+/**
+ * @brief Count the tokens in a template
+ */
+template<size_t N>
+constexpr size_t countTokens( const char (&tpl)[N] )
+{
+    size_t n = 0;
+    for (size_t p=0; p < N-1; p = scanToken(tpl,p).next) n++;
+    return n;
+}
+
+
+/**
+ * @brief Split a template into a table of tokens, and resolve keyword names. Use like
+ *      constexpr auto tokens = tmpl::tokenize<tmpl::countTokens(html)>(html,keywords);
+ */
+template<size_t NT, size_t N, size_t NK>
+constexpr TokenTable<NT> tokenize( const char (&tpl)[N], const char* const (&keywords)[NK] )
+{
+    TokenTable<NT> table {};
+    size_t p = 0;
+    for (size_t i=0; i<NT; i++) {
+        Scan s = scanToken(tpl,p);
+        if (s.token.kind == KEYWORD)
+            s.token.id = findKeyword(tpl + s.token.offset, s.token.length, keywords);
+        table.tokens[i] = s.token;
+        p = s.next;
+    }
+    return table;
+}
+
+} // namespace tmpl
+
+#endif // _html_template_h
@@ -0,0 +1,195 @@
+/**
+ * @file 		  latency.cpp
+ *
+ * Project		: Home automation
+ * Author		: Bernd Waldmann
+ * Created		: 16-Oct-2026
+ * Tabsize		: 4
+ *
+ * This Revision: $Id$
+ */
+
+/*
+   Copyright (C) 2024 Bernd Waldmann
+
+   This Source Code Form is subject to the terms of the Mozilla Public License, v. 2.0.
+   If a copy of the MPL was not distributed with this file, You can obtain one at http://mozilla.org/MPL/2.0/
+
+   SPDX-License-Identifier: MPL-2.0
+*/
+
+#include "latency.h"
+
+namespace latency {
+
+/// a message that has been received, but not yet forwarded
+struct Pending_t {
+    uint32_t key;
+    uint32_t t_received;    ///< [us] low 32 bits of esp_timer_get_time()
+    bool used;
+};
+
+static Pending_t pending[LATENCY_PENDING];
+
+static uint32_t histogram[NUM_BUCKETS];
+/// hopHistogram[id][i] counts messages forwarded to node id `id`, in bucket i
+static uint8_t hopHistogram[256][NUM_BUCKETS];
+/// bit i is set if messages have been forwarded to node id i since last clear
+static uint32_t hopBits[256/32];
+/// forwards that matched a pending message older than LATENCY_TIMEOUT_US
+static uint32_t nLate;
+
+/// written by loop(), read by the HTTP task
+static portMUX_TYPE mux = portMUX_INITIALIZER_UNLOCKED;
+
+
+static inline unsigned bucket( uint32_t us )
+{
+    unsigned i = 0;
+    while (i < NUM_BUCKETS-1 && us >= bucketLimit(i)) i++;
+    return i;
+}
+
+
+/**
+ * @brief Record time when a message was received, for each received message
+ * that is to be forwarded, in order of arrival. The oldest entry is replaced
+ * if the table is full.
+ * 
+ * @param now   [us] time of reception, low 32 bits of esp_timer_get_time()
+ */
+void received( uint32_t key, uint32_t now )
+{
+    portENTER_CRITICAL( &mux );
+    Pending_t* slot = &pending[0];
+    for (Pending_t& p : pending) {
+        if (!p.used) { slot = &p; break; }
+        if (now - p.t_received > now - slot->t_received) slot = &p;
+    }
+    slot->key = key;
+    slot->t_received = now;
+    slot->used = true;
+    portEXIT_CRITICAL( &mux );
+}
+
+
+/**
+ * @brief Match a sent message to the oldest pending message with the same key,
+ * and count its latency, or count it as late if it took longer than
+ * LATENCY_TIMEOUT_US. Sent messages that match nothing are ignored.
+ * For each sent message, in order of sending.
+ * 
+ * @param now   [us] time of sending, low 32 bits of esp_timer_get_time()
+ */
+void forwarded( uint32_t key, uint8_t nextHop, uint32_t now )
+{
+    portENTER_CRITICAL( &mux );
+    Pending_t* match = nullptr;
+    for (Pending_t& p : pending) 
+        if (p.used && p.key == key && (!match || now - p.t_received > now - match->t_received)) 
+            match = &p;
+    if (match) {
+        uint32_t us = now - match->t_received;
+        match->used = false;
+        if (us > LATENCY_TIMEOUT_US) {
+            nLate++;
+        } else {
+            unsigned i = bucket( us );
+            histogram[i]++;
+            uint8_t (&hist)[NUM_BUCKETS] = hopHistogram[nextHop];
+            if (hist[i] == UINT8_MAX)
+                for (uint8_t& h : hist) h >>= 1;
+            hist[i]++;
+            hopBits[nextHop >> 5] |= 1uL << (nextHop & 31);
+        }
+    }
+    portEXIT_CRITICAL( &mux );
+}
+
+
+/**
+ * @brief Reset all histograms. Pending messages are kept.
+ */
+void clear()
+{
+    portENTER_CRITICAL( &mux );
+    memset( histogram, 0, sizeof histogram );
+    for (unsigned w=0; w < 256/32; w++) {
+        uint32_t bits = hopBits[w];
+        while (bits) {
+            memset( hopHistogram[w*32 + __builtin_ctz(bits)], 0, sizeof hopHistogram[0] );
+            bits &= bits - 1;
+        }
+        hopBits[w] = 0;
+    }
+    nLate = 0;
+    portEXIT_CRITICAL( &mux );
+}
+
+
+template<typename T>
+static LatencySummary_t summarize( const T (&hist)[NUM_BUCKETS] )
+{
+    LatencySummary_t s {};
+    unsigned long long n = 0, sum = 0;
+    for (T h : hist) n += h;
+    bool have50 = false, have95 = false;
+    for (unsigned i=0; i<NUM_BUCKETS; i++) {
+        if (hist[i] == 0) continue;
+        sum += hist[i];
+        if (!have50 && sum * 100 >= n * 50) { s.p50 = bucketLimit(i); have50 = true; }
+        if (!have95 && sum * 100 >= n * 95) { s.p95 = bucketLimit(i); have95 = true; }
+        s.max = bucketLimit(i);
+    }
+    s.n = n;
+    return s;
+}
+
+
+/**
+ * @brief Get latency of all forwarded messages since last clear
+ */
+LatencySummary_t summary()
+{
+    uint32_t hist[NUM_BUCKETS];
+    portENTER_CRITICAL( &mux );
+    memcpy( hist, histogram, sizeof hist );
+    portEXIT_CRITICAL( &mux );
+    return summarize( hist );
+}
+
+
+/**
+ * @brief Get latency of messages forwarded to one next hop since last clear. 
+ * `n` is not a count of messages, but the sum of the (scaled) bins.
+ */
+LatencySummary_t hop( uint8_t id )
+{
+    uint8_t hist[NUM_BUCKETS];
+    portENTER_CRITICAL( &mux );
+    memcpy( hist, hopHistogram[id], sizeof hist );
+    portEXIT_CRITICAL( &mux );
+    return summarize( hist );
+}
+
+
+/**
+ * @brief Get the set of next hops that messages have been forwarded to since last clear
+ */
+void hops( uint32_t (&bitmap)[256/32] )
+{
+    portENTER_CRITICAL( &mux );
+    memcpy( bitmap, hopBits, sizeof bitmap );
+    portEXIT_CRITICAL( &mux );
+}
+
+
+/**
+ * @brief Get number of forwards since last clear that took longer than LATENCY_TIMEOUT_US
+ */
+uint32_t late()
+{
+    return nLate;
+}
+
+} // namespace latency
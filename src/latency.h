@@ -0,0 +1,90 @@
+/**
+ * @file 		  latency.h
+ *
+ * Project		: Home automation
+ * Author		: Bernd Waldmann
+ * Created		: 16-Oct-2026
+ * Tabsize		: 4
+ *
+ * This Revision: $Id$
+ */
+
+/*
+   Copyright (C) 2024 Bernd Waldmann
+
+   This Source Code Form is subject to the terms of the Mozilla Public License, v. 2.0.
+   If a copy of the MPL was not distributed with this file, You can obtain one at http://mozilla.org/MPL/2.0/
+
+   SPDX-License-Identifier: MPL-2.0
+*/
+
+/**
+ * @brief Time that forwarded messages spend in this device, as a repeater.
+ *
+ * Each message received is recorded with its timestamp from `previewMessage()` 
+ * in a small table of pending messages, keyed by sender/destination/sensor/type.
+ * When a message with the same key is sent, the time in between (to 
+ * `aftertransportSend()`) is counted in a histogram with logarithmic buckets, both 
+ * globally and for the next hop it was sent to. 
+ *
+ * Only messages addressed to another node are recorded. If the table is full,
+ * the oldest entry is replaced, so messages that are never forwarded do not
+ * stay for long. A forward that matches a message older than LATENCY_TIMEOUT_US
+ * is counted as late instead of in the histograms; a forward that matches no
+ * pending message is ignored.
+ *
+ * Bucket i counts latencies below 2^(i+7) us, i.e. 128 us ... 2 s, the last 
+ * bucket also counts anything above. Per-hop histograms use 8-bit bins that 
+ * are halved on overflow, 4 KB for all node ids.
+ */
+
+#ifndef _latency_h
+#define _latency_h
+
+#include <Arduino.h>
+
+/// number of messages that can wait for their forward at the same time
+#ifndef LATENCY_PENDING
+ #define LATENCY_PENDING    16
+#endif
+
+/// [us] messages forwarded after a longer time are counted as late
+#ifndef LATENCY_TIMEOUT_US
+ #define LATENCY_TIMEOUT_US (2 * 1000 * 1000)
+#endif
+
+namespace latency {
+
+const unsigned NUM_BUCKETS = 16;
+
+/// summary of a latency histogram, times are upper bounds of buckets in us
+struct LatencySummary_t {
+    uint32_t n;         ///< number of forwarded messages
+    uint32_t p50, p95;  ///< 50% / 95% of messages were faster than this
+    uint32_t max;       ///< all messages were faster than this
+};
+
+/// build key for a message
+inline uint32_t key( uint8_t sender, uint8_t destination, uint8_t sensor, uint8_t type )
+{
+    return (uint32_t(sender) << 24) | (uint32_t(destination) << 16) | (uint32_t(sensor) << 8) | type;
+}
+
+void received( uint32_t key, uint32_t now );
+void forwarded( uint32_t key, uint8_t nextHop, uint32_t now );
+void clear();
+
+LatencySummary_t summary();
+LatencySummary_t hop( uint8_t id );
+void hops( uint32_t (&bitmap)[256/32] );
+uint32_t late();
+
+/// upper bound of bucket `i` in us
+inline uint32_t bucketLimit( unsigned i )
+{
+    return 1uL << (i + 7);
+}
+
+} // namespace latency
+
+#endif // _latency_h
@@ -0,0 +1,253 @@
+/**
+ * @file 		  liveness.cpp
+ *
+ * Project		: Home automation
+ * Author		: Bernd Waldmann
+ * Created		: 16-Oct-2026
+ * Tabsize		: 4
+ *
+ * This Revision: $Id$
+ */
+
+/*
+   Copyright (C) 2024 Bernd Waldmann
+
+   This Source Code Form is subject to the terms of the Mozilla Public License, v. 2.0.
+   If a copy of the MPL was not distributed with this file, You can obtain one at http://mozilla.org/MPL/2.0/
+
+   SPDX-License-Identifier: MPL-2.0
+*/
+
+#include <esp_timer.h>
+#include "liveness.h"
+
+namespace liveness {
+
+const uint16_t NOT_IN_HEAP = 0xFFFF;
+
+/// everything about one node
+struct Record_t {
+    uint32_t lastSeen;      ///< `liveTime()` of last message, 0 if never
+    uint32_t lastReport;    ///< `liveTime()` of first message of last burst
+    uint32_t interval16;    ///< [s/16] moving average of time between reports
+    uint32_t deadline;      ///< `liveTime()` when node will be offline
+    uint32_t gap;           ///< [s] silence before node came back online
+    uint16_t heapPos;       ///< index in `heap`, or NOT_IN_HEAP
+    uint8_t reports;        ///< number of intervals learned, saturates at 255
+    State state;
+};
+
+static Record_t records[256];
+
+/// node ids, ordered as binary min-heap by deadline
+static uint8_t heap[256];
+static unsigned heapSize;
+
+/// bit i is set if node id i is offline
+static uint32_t offlineBits[256/32];
+/// bit i is set if node id i came back online, and this was not yet returned by `nextEvent()`
+static uint32_t onlineEvents[256/32];
+/// incremented whenever a record changes
+static uint32_t nChanges;
+
+/// written by loop(), read by the HTTP task
+static portMUX_TYPE mux = portMUX_INITIALIZER_UNLOCKED;
+
+
+/**
+ * @brief Seconds since startup, plus 1 so that 0 can mean "never"
+ */
+static inline uint32_t liveTime()
+{
+    return uint32_t(esp_timer_get_time() / 1000000) + 1;
+}
+
+
+static inline uint32_t timeout( const Record_t& r )
+{
+    uint32_t t = LIVENESS_FACTOR * (r.interval16 / 16);
+    return (t < LIVENESS_MIN_TIMEOUT_S) ? LIVENESS_MIN_TIMEOUT_S : t;
+}
+
+//----- binary heap, all with `mux` held
+
+static inline bool earlier( unsigned a, unsigned b )
+{
+    return records[heap[a]].deadline < records[heap[b]].deadline;
+}
+
+
+static inline void swap( unsigned a, unsigned b )
+{
+    uint8_t t = heap[a]; heap[a] = heap[b]; heap[b] = t;
+    records[heap[a]].heapPos = a;
+    records[heap[b]].heapPos = b;
+}
+
+
+static void siftUp( unsigned i )
+{
+    while (i > 0 && earlier( i, (i-1)/2 )) {
+        swap( i, (i-1)/2 );
+        i = (i-1)/2;
+    }
+}
+
+
+static void siftDown( unsigned i )
+{
+    for (;;) {
+        unsigned l = 2*i + 1, r = l + 1, m = i;
+        if (l < heapSize && earlier( l, m )) m = l;
+        if (r < heapSize && earlier( r, m )) m = r;
+        if (m == i) return;
+        swap( i, m );
+        i = m;
+    }
+}
+
+
+/// insert node, or move it to its new place after its deadline changed
+static void schedule( uint8_t id )
+{
+    Record_t& r = records[id];
+    if (r.heapPos == NOT_IN_HEAP) {
+        r.heapPos = heapSize;
+        heap[heapSize++] = id;
+        siftUp( r.heapPos );
+    } else {
+        siftUp( r.heapPos );
+        siftDown( r.heapPos );
+    }
+}
+
+
+/// remove node with earliest deadline
+static uint8_t pop()
+{
+    uint8_t id = heap[0];
+    swap( 0, --heapSize );
+    records[id].heapPos = NOT_IN_HEAP;
+    if (heapSize) siftDown( 0 );
+    return id;
+}
+
+//----- API
+
+/**
+ * @brief Note that a message was received from a node.
+ */
+void seen( uint8_t id )
+{
+    if (id == 255) return;      // nodes that have no id yet
+    uint32_t now = liveTime();
+    portENTER_CRITICAL( &mux );
+    Record_t& r = records[id];
+    if (r.lastSeen == 0) {
+        r.heapPos = NOT_IN_HEAP;
+        r.lastReport = now;
+    } else if (r.state == OFFLINE) {
+        // the long silence says nothing about the usual interval
+        r.gap = now - r.lastSeen;
+        r.lastReport = now;
+        r.state = ONLINE;
+        offlineBits[id >> 5] &= ~(1uL << (id & 31));
+        onlineEvents[id >> 5] |= 1uL << (id & 31);
+    } else if (now - r.lastReport >= LIVENESS_BURST_S) {
+        uint32_t dt16 = (now - r.lastReport) * 16;
+        if (r.reports == 0)
+            r.interval16 = dt16;
+        else
+            r.interval16 = int32_t(r.interval16) + (int32_t(dt16) - int32_t(r.interval16)) / 8;
+        if (r.reports < UINT8_MAX) r.reports++;
+        r.lastReport = now;
+    }
+    r.lastSeen = now;
+    if (r.reports >= LIVENESS_MIN_REPORTS) {
+        if (r.state == LEARNING) r.state = ONLINE;
+        r.deadline = now + timeout(r);
+        schedule( id );
+    }
+    nChanges++;
+    portEXIT_CRITICAL( &mux );
+}
+
+
+/**
+ * @brief Get next change of state: nodes that came back online first,
+ * then nodes that are overdue. Call from loop() until it returns false.
+ *
+ * @return true if `ev` was filled in
+ */
+bool nextEvent( Event_t& ev )
+{
+    uint32_t now = liveTime();
+    bool found = false;
+    portENTER_CRITICAL( &mux );
+    for (unsigned w=0; w < 256/32 && !found; w++) {
+        if (onlineEvents[w] == 0) continue;
+        unsigned id = w*32 + __builtin_ctz( onlineEvents[w] );
+        onlineEvents[w] &= onlineEvents[w] - 1;
+        const Record_t& r = records[id];
+        ev = Event_t{ uint8_t(id), true, r.gap, r.interval16 / 16 };
+        found = true;
+    }
+    if (!found && heapSize && records[heap[0]].deadline <= now) {
+        uint8_t id = pop();
+        Record_t& r = records[id];
+        r.state = OFFLINE;
+        offlineBits[id >> 5] |= 1uL << (id & 31);
+        nChanges++;
+        ev = Event_t{ id, false, now - r.lastSeen, r.interval16 / 16 };
+        found = true;
+    }
+    portEXIT_CRITICAL( &mux );
+    return found;
+}
+
+
+/**
+ * @brief Get liveness of one node
+ */
+NodeLiveness_t node( uint8_t id )
+{
+    uint32_t now = liveTime();
+    portENTER_CRITICAL( &mux );
+    const Record_t& r = records[id];
+    NodeLiveness_t l {
+        r.state,
+        r.reports ? r.interval16 / 16 : 0,
+        r.lastSeen ? now - r.lastSeen : UINT32_MAX,
+        (r.reports >= LIVENESS_MIN_REPORTS) ? timeout(r) : 0
+    };
+    portEXIT_CRITICAL( &mux );
+    return l;
+}
+
+
+/**
+ * @brief Get the set of nodes that are offline
+ *
+ * @return unsigned number of nodes offline
+ */
+unsigned offline( uint32_t (&bitmap)[256/32] )
+{
+    unsigned n = 0;
+    portENTER_CRITICAL( &mux );
+    memcpy( bitmap, offlineBits, sizeof bitmap );
+    portEXIT_CRITICAL( &mux );
+    for (uint32_t w : bitmap) n += __builtin_popcount( w );
+    return n;
+}
+
+
+/**
+ * @brief Get a number that changes whenever a node is seen or goes offline,
+ * e.g. for an ETag
+ */
+uint32_t changes()
+{
+    return nChanges;
+}
+
+} // namespace liveness
@@ -0,0 +1,94 @@
+/**
+ * @file 		  liveness.h
+ *
+ * Project		: Home automation
+ * Author		: Bernd Waldmann
+ * Created		: 16-Oct-2026
+ * Tabsize		: 4
+ *
+ * This Revision: $Id$
+ */
+
+/*
+   Copyright (C) 2024 Bernd Waldmann
+
+   This Source Code Form is subject to the terms of the Mozilla Public License, v. 2.0.
+   If a copy of the MPL was not distributed with this file, You can obtain one at http://mozilla.org/MPL/2.0/
+
+   SPDX-License-Identifier: MPL-2.0
+*/
+
+/**
+ * @brief Detect nodes that have stopped talking.
+ *
+ * For each node, the time between reports is learned as an exponentially
+ * weighted moving average (weight 1/8). Messages less than LIVENESS_BURST_S
+ * apart count as one report, since nodes usually send several values at once.
+ * After LIVENESS_MIN_REPORTS intervals, the node gets a deadline of
+ * LIVENESS_FACTOR times its interval (at least LIVENESS_MIN_TIMEOUT_S) after
+ * the last message.
+ *
+ * Deadlines are kept in a binary min-heap, so `seen()` costs O(log n), and
+ * finding overdue nodes costs O(1) if there are none, O(log n) for each one.
+ * Transitions to offline and back online are returned by `nextEvent()`.
+ */
+
+#ifndef _liveness_h
+#define _liveness_h
+
+#include <Arduino.h>
+
+/// messages closer than this [s] are one report, e.g. temperature and humidity
+#ifndef LIVENESS_BURST_S
+ #define LIVENESS_BURST_S       10
+#endif
+
+/// number of intervals to learn, before a node can be declared offline
+#ifndef LIVENESS_MIN_REPORTS
+ #define LIVENESS_MIN_REPORTS   3
+#endif
+
+/// node is offline when silent for this many times its usual interval
+#ifndef LIVENESS_FACTOR
+ #define LIVENESS_FACTOR        3
+#endif
+
+/// [s] lower limit of time until a node is declared offline
+#ifndef LIVENESS_MIN_TIMEOUT_S
+ #define LIVENESS_MIN_TIMEOUT_S 300
+#endif
+
+namespace liveness {
+
+enum State : uint8_t {
+    LEARNING,   ///< not enough reports yet to know the interval
+    ONLINE,     ///< reporting as expected
+    OFFLINE     ///< silent for longer than its timeout
+};
+
+/// liveness of one node
+struct NodeLiveness_t {
+    State state;
+    uint32_t interval;  ///< [s] usual time between reports, 0 if unknown
+    uint32_t silent;    ///< [s] since last message, UINT32_MAX if never seen
+    uint32_t timeout;   ///< [s] node is offline when silent for longer than this, 0 if unknown
+};
+
+/// a change of state, as returned by `nextEvent()`
+struct Event_t {
+    uint8_t id;
+    bool online;        ///< true if node came back, false if it went offline
+    uint32_t silent;    ///< [s] time without message
+    uint32_t interval;  ///< [s] usual time between reports
+};
+
+void seen( uint8_t id );
+bool nextEvent( Event_t& ev );
+
+NodeLiveness_t node( uint8_t id );
+unsigned offline( uint32_t (&bitmap)[256/32] );
+uint32_t changes();
+
+} // namespace liveness
+
+#endif // _liveness_h
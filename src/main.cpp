@@ -78,10 +78,27 @@
 #include <rom/rtc.h>            // Apache-2.0 license
 #include <esp32/clk.h>
 #include <esp_pm.h>
+#include <esp_timer.h>
 
 //----- my headers
 #include "ansi.h"
+#include "html_template.h"
+#include "text_writer.h"
+#include "stats.h"
+#include "persist.h"
+#include "latency.h"
+#include "traffic.h"
+#include "airtime.h"
+#include "dedup.h"
+#include "liveness.h"
+#include "profile.h"
+#include "radio_events.h"
+#include "scheduler.h"
+#include "cpuload.h"
+#include "health.h"
+#include "table.h"
 #include "Revision.h"   // automatically generated header file with SVN revision
+#include "index_html_gz.h" // automatically generated, compressed web UI shell
 #include "secrets.h"    // WiFi password etc
 
 //=====================================================================
@@ -138,6 +155,31 @@
 //----- NTP
 #define NTP_SERVER  "fritz.box"
 
+//----- HTTP server task
+#ifndef HTTP_TASK_CORE
+ #define HTTP_TASK_CORE         0   // core 0 is shared with the network stack, loop() runs on core 1
+#endif
+#ifndef HTTP_TASK_PRIORITY
+ #define HTTP_TASK_PRIORITY     1   // same as loop()
+#endif
+#define HTTP_TASK_STACK_SIZE    8192
+
+//----- Server-Sent Events for live update of web UI
+#ifndef SSE_INTERVAL
+ #define SSE_INTERVAL       1000    // [ms] changes are collected for this long, then pushed
+#endif
+#define SSE_MAX_CLIENTS     3       // max # of concurrent /events subscribers
+#define SSE_KEEPALIVE       15000   // [ms] max time without any message to subscribers
+
+//----- browser may cache the static web UI shell for this long
+#define SHELL_MAX_AGE       "86400"   // [s]
+
+//----- server-rendered page is re-used for this long ...
+#ifndef PAGE_CACHE_MAX_AGE
+ #define PAGE_CACHE_MAX_AGE     2000    // [ms] ... even if statistics have changed
+#endif
+#define PAGE_CACHE_MAX_IDLE     60000   // [ms] ... if statistics have not changed
+
 //----- MySensors MQTT (only applies to gateway mode)
 #define MY_CONTROLLER_URL_ADDRESS "ha-server"
 #define MY_MQTT_PUBLISH_TOPIC_PREFIX "my/E/stat"
@@ -169,6 +211,23 @@
 const unsigned long MIN_REPORT_INTERVAL = 60 MINUTES;
 /// time between temperature measurements
 const unsigned long REPORT_TEMPERATURE_INTERVAL = 30 MINUTES;
+/// time between checks of NTP, checkpoints and liveness, which have their own intervals
+const unsigned long HOUSEKEEPING_INTERVAL = 1 SECONDS;
+/// longest time loop() sleeps, so ArduinoOTA still gets polled
+const unsigned long LOOP_MAX_SLEEP = 100;
+/// longest time loop() sleeps if MySensors runs in the same task, so the radio still gets polled
+const unsigned long LOOP_POLL_SLEEP = 1;
+/// time between samples of stack and heap usage
+const unsigned long HEALTH_INTERVAL = 1 MINUTES;
+
+/// statistics of loop() iteration time, since last report
+struct LoopTiming_t {
+    uint32_t n;         ///< number of iterations
+    uint32_t maxUs;     ///< longest iteration in µs
+    uint64_t sumUs;     ///< total time of all iterations in µs
+};
+/// [0] iterations without, [1] with concurrent HTTP requests
+LoopTiming_t loopTiming[2];
 
 //---------------------------------------------------------------------
 #pragma endregion
@@ -224,8 +283,15 @@ const unsigned long REPORT_TEMPERATURE_INTERVAL = 30 MINUTES;
 
 #define SENSOR_ID_ARC		98
 #define V_TYPE_ARC			V_VAR5
+#define V_TYPE_ARC_HIST		V_VAR4
 MyMessage arcMessage = MyMessage(SENSOR_ID_ARC, V_TYPE_ARC);
 
+#define SENSOR_ID_LATENCY	97
+#define V_TYPE_LATENCY		V_VAR5
+
+#define SENSOR_ID_LIVENESS	94
+#define V_TYPE_LIVENESS		V_VAR5
+
 #define SENSOR_ID_CMND      96
 
 #ifdef USE_DS18B20
@@ -264,24 +330,9 @@ WiFiUDP udpClient;
 /// static buffer for assembling various messages
 char msgbuf[256];
 
+/// id of the checkpoint job, for `sched::trigger()` after /clear
+static int persistJobId = -1;
 
-/// for counting indication() status notifications
-struct RxTxStats_t {
-	unsigned nRx, nTx, nGwRx, nGwTx, nErr;
-} rxtxStats;
-
-/// nMessagesRx[i] counts messages received from node id `i`
-unsigned nMessagesRx[256];
-/// nMessagesTx[i] counts messages sent to node id `i`
-unsigned nMessagesTx[256];
-/// nRetries[i] counts mretries required for messages sent to node id `i`
-unsigned nRetries[256];
-
-struct ArcStats_t {
-    unsigned packets;   ///< number of packets sent
-    unsigned retries;   ///< number of retries required
-    unsigned success;   ///< success rate in percent
-} arcStats;
 
 const char* reset_reasons[] = {
 "0: none",
@@ -303,8 +354,6 @@ const char* reset_reasons[] = {
 "16: RTC Watch dog reset digital core and rtc module"
 };
 
-time_t t_last_clear = 0;
-
 time_t getTimeNow()
 {
 #ifdef USE_NTP
@@ -319,39 +368,41 @@ time_t getTimeNow()
 //=====================================================================
 #pragma region ARC statistics
 
+/// RF24 data rate in kbit/s, for the airtime estimate
+#if MY_RF24_DATARATE == RF24_250KBPS
+ #define RF24_DATARATE_KBPS 250
+#elif MY_RF24_DATARATE == RF24_2MBPS
+ #define RF24_DATARATE_KBPS 2000
+#else
+ #define RF24_DATARATE_KBPS 1000
+#endif
+
+
 /**
- * @brief Collect statistics re Automatic Retries Count (ARC) for RF24.
+ * @brief Get Automatic Retries Count (ARC) of RF24.
  * Call this function immediately after each `send()` call.
  * 
  * @return int  number of retries required for most recent send
  * 
  */
-int collectArcStatistics()
+int lastSendRetries()
 {
 	int rssi = transportHALGetSendingRSSI();	// boils down to (-29 - (8 * (RF24_getObserveTX() & 0xF)))
-	int arc = (-(rssi+29))/8;
-	arcStats.packets++;         // # of packets sent
-	arcStats.retries += arc;    // # of retries required
-    arcStats.success = 
-        arcStats.packets ? 
-            (100uL * arcStats.packets) / (arcStats.packets + arcStats.retries) 
-            : 100;
-    return arc;
+	return (-(rssi+29))/8;
 }
 
 
 /**
- * @brief Reset all statistics counters to zero. Do this every hour or so
+ * @brief Reset all statistics counters to zero. Do this every hour or so.
+ * Totals since startup are not affected.
  * 
  */
 void initStats()
 {
-	memset( nMessagesRx, 0, sizeof(nMessagesRx));
-	memset( nMessagesTx, 0, sizeof(nMessagesTx));
-	memset( nRetries, 0, sizeof(nRetries));
-	memset( &rxtxStats, 0, sizeof(rxtxStats) );
-    memset( &arcStats, 0, sizeof arcStats );
-    t_last_clear = getTimeNow();
+    stats::clear( getTimeNow() );
+    latency::clear();
+    traffic::clear();
+    airtime::clear();
 }
 
 
@@ -372,16 +423,281 @@ const char* reportArcStatistics()
 	//              				    1...5...10...15...20...25 max payload
 	//				                    |   |    |    |    |    |
 	static char payload[26];	//      {P:65535;R:65535;S:100}
+    RxTxStats_t rxtx;
+    ArcStats_t arc;
+    stats::globals( rxtx, arc );
 	snprintf(payload, sizeof payload, "{P:%u,R:%u,S:%u}",
-        arcStats.packets, arcStats.retries, arcStats.success );
+        arc.packets, arc.retries, arc.success );
 
-    //memset( &arcStats, 0, sizeof arcStats );
 	arcMessage.setSensor(SENSOR_ID_ARC).setType(V_TYPE_ARC);
 	delay(10);
     send(arcMessage.set(payload));
 	return payload;
 }
 
+
+/**
+ * @brief Send JSON-esque message with distribution of retries since last clear.
+ * Call this together with `reportArcStatistics()`.
+ * 
+ * @return const char* pointer to string sent to MySensors, like "{M:0,H:3,X:15,L:1}"
+ *
+ * M = median of retries, H = 95th percentile, X = max, L = % of packets at ARC limit
+ */
+const char* reportArcHistogram()
+{
+	//              				    1...5...10...15...20...25 max payload
+	//				                    |   |    |    |    |    |
+	static char payload[26];	//      {M:15,H:15,X:15,L:100}
+    RxTxStats_t rxtx;
+    ArcStats_t arc;
+    stats::globals( rxtx, arc );
+    stats::ArcPercentiles_t p = stats::arcPercentiles( arc.histogram );
+	snprintf(payload, sizeof payload, "{M:%u,H:%u,X:%u,L:%u}",
+        p.p50, p.p95, p.max, p.atLimit );
+
+	arcMessage.setSensor(SENSOR_ID_ARC).setType(V_TYPE_ARC_HIST);
+	delay(10);
+    send(arcMessage.set(payload));
+	return payload;
+}
+
+
+/**
+ * @brief Format a time in us as ms, with one decimal if below 100 ms
+ */
+static void formatMs( char* buf, size_t size, uint32_t us )
+{
+    if (us < 100000uL)
+        snprintf( buf, size, "%u.%u", unsigned(us / 1000), unsigned((us % 1000) / 100) );
+    else
+        snprintf( buf, size, "%u", unsigned(us / 1000) );
+}
+
+
+/**
+ * @brief Send JSON-esque message with forwarding latency since last clear.
+ * 
+ * @return const char* pointer to string sent to MySensors, like "{M:0.2,H:1.0,X:16.3}"
+ *
+ * M = median in ms, H = 95th percentile, X = max. These are upper bounds of histogram buckets.
+ */
+const char* reportLatency()
+{
+	//              				    1...5...10...15...20...25 max payload
+	//				                    |   |    |    |    |    |
+	static char payload[26];	//      {M:2097,H:2097,X:2097}
+    char m[8], h[8], x[8];
+    latency::LatencySummary_t l = latency::summary();
+    formatMs( m, sizeof m, l.p50 );
+    formatMs( h, sizeof h, l.p95 );
+    formatMs( x, sizeof x, l.max );
+	snprintf(payload, sizeof payload, "{M:%s,H:%s,X:%s}", m, h, x );
+
+	arcMessage.setSensor(SENSOR_ID_LATENCY).setType(V_TYPE_LATENCY);
+	delay(10);
+    send(arcMessage.set(payload));
+	return payload;
+}
+
+
+/**
+ * @brief Format a time in us as ms in at most 3 characters: with one decimal 
+ * below 10 ms, "999" for 1 s or more
+ */
+static void formatMsShort( char* buf, size_t size, uint32_t us )
+{
+    if (us < 10000uL)
+        snprintf( buf, size, "%u.%u", unsigned(us / 1000), unsigned((us % 1000) / 100) );
+    else if (us < 1000000uL)
+        snprintf( buf, size, "%u", unsigned(us / 1000) );
+    else
+        snprintf( buf, size, "999" );
+}
+
+
+/**
+ * @brief Send one JSON-esque message with forwarding latency since last clear 
+ * for each next hop, like "{N:12,M:0.2,H:1.0,X:16}". 
+ * Call this together with `reportLatency()`.
+ * 
+ * @return unsigned number of messages sent
+ *
+ * N = node id of next hop, M,H,X as for `reportLatency()`, but with at most 3 
+ * characters each, so that the message fits into the 25 byte payload.
+ */
+unsigned reportLatencyHops()
+{
+	//              				    1...5...10...15...20...25 max payload
+	//				                    |   |    |    |    |    |
+	static char payload[26];	//      {N:255,M:999,H:999,X:999}
+    uint32_t hops[256/32];
+    unsigned n = 0;
+    latency::hops( hops );
+    stats::forEachNode( hops, [&](unsigned id) {
+        char m[4], h[4], x[4];
+        latency::LatencySummary_t l = latency::hop( id );
+        formatMsShort( m, sizeof m, l.p50 );
+        formatMsShort( h, sizeof h, l.p95 );
+        formatMsShort( x, sizeof x, l.max );
+        snprintf(payload, sizeof payload, "{N:%u,M:%s,H:%s,X:%s}", id, m, h, x );
+        log_i("Latency: %s",payload);
+
+        arcMessage.setSensor(SENSOR_ID_LATENCY).setType(V_TYPE_LATENCY);
+        delay(10);
+        send(arcMessage.set(payload));
+        n++;
+    });
+	return n;
+}
+
+
+/**
+ * @brief Report a node that went offline or came back, via log, syslog and
+ * a JSON-esque message like "{N:12,O:0,T:905}"
+ *
+ * N = node id, O = 1 if online, 0 if offline, T = seconds without message
+ */
+void reportLiveness( const liveness::Event_t& ev )
+{
+	static char payload[26];	//      {N:255,O:1,T:4294967295}
+	snprintf(payload, sizeof payload, "{N:%u,O:%u,T:%u}", 
+        unsigned(ev.id), unsigned(ev.online), unsigned(ev.silent) );
+    if (ev.online)
+        log_i("node %u online after %u s", unsigned(ev.id), unsigned(ev.silent));
+    else
+        log_w("node %u offline, silent for %u s, usually every %u s", 
+            unsigned(ev.id), unsigned(ev.silent), unsigned(ev.interval));
+#ifdef USE_SYSLOG
+    if (ev.online)
+        syslog.logf( LOG_NOTICE, "node %u online after %u s", unsigned(ev.id), unsigned(ev.silent) );
+    else
+        syslog.logf( LOG_WARNING, "node %u offline, silent for %u s, usually every %u s", 
+            unsigned(ev.id), unsigned(ev.silent), unsigned(ev.interval) );
+#endif
+	arcMessage.setSensor(SENSOR_ID_LIVENESS).setType(V_TYPE_LIVENESS);
+    send(arcMessage.set(payload));
+}
+
+
+/**
+ * @brief Report a stack or heap threshold crossed, via log and syslog
+ */
+void reportHealth( const health::Warning_t& w )
+{
+    char line[80];
+    switch (w.kind) {
+    case health::STACK:
+        snprintf( line, sizeof line, "task %s has only %u bytes of stack left", 
+            w.task, unsigned(w.value) );
+        break;
+    case health::FREE_HEAP:
+        snprintf( line, sizeof line, w.cleared ? "free heap back to %u bytes" : "free heap low: %u bytes", 
+            unsigned(w.value) );
+        break;
+    case health::FRAGMENTATION:
+        snprintf( line, sizeof line, w.cleared ? "heap fragmentation back to %u.%u%%" : "heap fragmented: %u.%u%%", 
+            unsigned(w.value) / 10, unsigned(w.value) % 10 );
+        break;
+    case health::DROPPED:
+        snprintf( line, sizeof line, "%u health warnings dropped", unsigned(w.value) );
+        break;
+    default:
+        return;
+    }
+    if (w.cleared)
+        log_i("%s",line);
+    else
+        log_w("%s",line);
+#ifdef USE_SYSLOG
+    syslog.log( w.cleared ? LOG_NOTICE : LOG_WARNING, line );
+#endif
+}
+
+
+/**
+ * @brief Report loop() iteration times and time spent sleeping since last report, 
+ * then reset them
+ * 
+ * @return const char*  pointer to report text
+ */
+const char* reportLoopTiming()
+{
+    static char report[128];
+    const LoopTiming_t& t0 = loopTiming[0];
+    const LoopTiming_t& t1 = loopTiming[1];
+    sched::IdleStats_t idle;
+    sched::takeIdle( idle );
+    unsigned idlePermille = idle.totalUs ? unsigned(idle.idleUs * 1000 / idle.totalUs) : 0;
+    snprintf( report, sizeof report, 
+        "loop() avg/max us: %u/%u (n=%u), with HTTP %u/%u (n=%u), idle %u.%u%%",
+        t0.n ? unsigned(t0.sumUs / t0.n) : 0, t0.maxUs, t0.n,
+        t1.n ? unsigned(t1.sumUs / t1.n) : 0, t1.maxUs, t1.n,
+        idlePermille / 10, idlePermille % 10 );
+    memset( loopTiming, 0, sizeof loopTiming );
+    return report;
+}
+
+
+/**
+ * @brief Report CPU load per core and CPU share of busy tasks since last report, 
+ * then start a new period
+ */
+void reportCpuLoad()
+{
+    char line[160];
+    int len = snprintf( line, sizeof line, "CPU load (%s)", cpuload::method() );
+    for (unsigned i=0; i<cpuload::numCores() && len < (int)sizeof line; i++) {
+        cpuload::CoreLoad_t c;
+        cpuload::core( i, c );
+        len += snprintf( line+len, sizeof line - len, "%s core %u avg/max: %u.%u/%u.%u%%", 
+            i ? "," : ":", i, c.period/10, c.period%10, c.periodMax/10, c.periodMax%10 );
+    }
+    log_i("%s",line);
+#ifdef USE_SYSLOG
+    syslog.log(LOG_INFO, line);
+#endif
+
+    // tasks above 0.1%, by rolling average
+    cpuload::TaskLoad_t tasks[8];
+    unsigned n = cpuload::tasks( tasks, sizeof tasks / sizeof tasks[0] );
+    len = snprintf( line, sizeof line, "CPU tasks:" );
+    for (unsigned i=0; i<n && len < (int)sizeof line; i++) {
+        const cpuload::TaskLoad_t& t = tasks[i];
+        if (t.period == 0) continue;
+        len += snprintf( line+len, sizeof line - len, " %s %u.%u%%", 
+            t.name, t.period/10, t.period%10 );
+    }
+    log_i("%s",line);
+#ifdef USE_SYSLOG
+    syslog.log(LOG_INFO, line);
+#endif
+    cpuload::nextPeriod();
+}
+
+
+/**
+ * @brief Report time spent in subsystems, one line per section that was 
+ * measured, and start a new period for the maximum times
+ */
+void reportProfile()
+{
+    for (unsigned s=0; s<profile::NUM_SECTIONS; s++) {
+        profile::SectionStats_t st;
+        profile::read( profile::Section(s), st );
+        if (st.n == 0) continue;
+        char line[96];
+        snprintf( line, sizeof line, "profile %s: n=%u avg/max us: %u/%u, max ever %u",
+            profile::name( profile::Section(s) ), unsigned(st.n), unsigned(st.sumUs / st.n), 
+            unsigned(st.maxUs), unsigned(st.maxEverUs) );
+        log_i("%s",line);
+#ifdef USE_SYSLOG
+        syslog.log(LOG_INFO, line);
+#endif
+    }
+    profile::nextPeriod();
+}
+
 //---------------------------------------------------------------------
 #pragma endregion
 //=====================================================================
@@ -401,6 +717,7 @@ void setupOTA()
 	});
 	ArduinoOTA.onEnd([]() {
 		Serial.println("\nArduinoOTA end");
+        persist::saveRtc();     // device restarts after update
 	});
 	ArduinoOTA.onProgress([](unsigned int progress, unsigned int total) {
 		Serial.printf("OTA Progress: %u%%\r", (progress / (total / 100)));
@@ -432,7 +749,7 @@ void setupOTA()
 #ifdef USE_HTTP 
 
 
-const char index_html[] PROGMEM = R"rawliteral(
+constexpr char index_html[] PROGMEM = R"rawliteral(
 <!DOCTYPE HTML><html>
 <head>
   <title>%TITLE%</title>
@@ -443,6 +760,8 @@ const char index_html[] PROGMEM = R"rawliteral(
     button { margin: 5px; padding:10px; min-height:20px; min-width: 80px; float:left; }
     .mph { color: #606060; font-size:smaller; }
     .suc { color: #fc03fc; font-size:smaller; }
+    .arc { color: #a05000; font-size:smaller; }
+    .off { background-color: #e0a0a0; }
   </style>
 </head>
 <body>
@@ -464,15 +783,20 @@ const char index_html[] PROGMEM = R"rawliteral(
 R"rawliteral(
   </p>  
   <p>
-    ARC <b>%SUCCESS%</b>%% success, <b>%PACKETS%</b> packets, <b>%RETRIES%</b> retries.&emsp;
+    ARC <b id="suc">%SUCCESS%</b>%% success, <b id="pkt">%PACKETS%</b> packets, <b id="ret">%RETRIES%</b> retries,
+    retries p50/p95/max: <b id="arcp">%ARC_PERCENTILES%</b>, at limit: <b id="arcl">%ARC_AT_LIMIT%</b>%%&emsp;
   </p>
   <p>
-    Node rx:<b>%NRX%</b>&ensp;tx:<b>%NTX%</b>&ensp;err:<b>%NERR%</b> (<b>%ERROR_RATE%</b>%%)&emsp;
+    Forwarding latency p50/p95/max: <b id="lat">%LATENCY%</b> ms%LATENCY_HOPS%&emsp;
+    channel busy minute/hour/day: <b id="busy">%CHANNEL_BUSY%</b> %%&emsp;
+  </p>
+  <p>
+    Node rx:<b id="nrx">%NRX%</b>&ensp;tx:<b id="ntx">%NTX%</b>&ensp;err:<b id="nerr">%NERR%</b> (<b id="erate">%ERROR_RATE%</b>%%)&emsp;
 )rawliteral"
 
 #ifdef OPERATE_AS_GATEWAY
  R"rawliteral(
-    Gateway: rx:<b>%NGWRX%</b>&ensp;tx:<b>%NGWTX%</b>
+    Gateway: rx:<b id="gwrx">%NGWRX%</b>&ensp;tx:<b id="gwtx">%NGWTX%</b>
  )rawliteral"
 #endif
 
@@ -482,193 +806,968 @@ R"rawliteral(
     since %LASTCLEAR% (%ELAPSED%)&emsp;
     time is now %NOW%
   </p>
+  <p>
+    loop() max:<b>%LOOPMAX%</b>&thinsp;&micro;s, with web clients:<b>%LOOPMAX_HTTP%</b>&thinsp;&micro;s&emsp;
+    page cache hits:<b>%CACHE_HITS%</b> misses:<b>%CACHE_MISSES%</b>
+  </p>
   <p>%TABLE%</p>
   <form action="/clear"><button type="submit">Clear</button></form>
   <form action="/reboot"><button type="submit">Restart</button></form>
+  <script>
+    function set(id,v) { var e=document.getElementById(id); if (e) e.textContent=v; }
+    new EventSource("/events").onmessage = function(ev) {
+      var d = JSON.parse(ev.data), el = d.now - d.lastClear;
+      set("nrx",d.rx); set("ntx",d.tx); set("nerr",d.err); 
+      set("erate", d.tx ? Math.floor(100*d.err/d.tx) : 0);
+      set("gwrx",d.gwRx); set("gwtx",d.gwTx);
+      set("suc",d.arc[2]); set("pkt",d.arc[0]); set("ret",d.arc[1]);
+      set("arcp",d.arc[3]+"/"+d.arc[4]+"/"+d.arc[5]); set("arcl",d.arc[6]);
+      d.nodes.forEach(function(n) {
+        var c = document.getElementById("n"+n[0]), h = "";
+        if (!c) return;
+        if (n[1] > 0) {
+          h = "<b>" + n[1] + "</b>";
+          if (el > 0) h += "&ensp;<span class='mph'>" + Math.floor(n[1]*3600/el) + "/h</span>";
+        }
+        if (n[2] > 0) h += "<br/><span class='suc'>" + Math.floor(100*n[2]/(n[2]+n[3])) + "%%</span>"
+          + "<br/><span class='arc'>" + n[4] + "/" + n[5] + "/" + n[6] + (n[7] ? " " + n[7] + "%%" : "") + "</span>";
+        c.innerHTML = h;
+      });
+    };
+  </script>
 </body>
 </html>
 )rawliteral";
 
+/// all keywords that can be used in templates, as X(name)
+#define PAGE_KEYWORDS(X) \
+    X(IPADDR) X(HOSTNAME) X(NODEID) X(VERSION) X(PARENT) \
+    X(POWER) X(CHANNEL) \
+    X(NRX) X(NTX) X(NERR) X(NGWRX) X(NGWTX) X(ERROR_RATE) \
+    X(PACKETS) X(RETRIES) X(SUCCESS) X(ARC_PERCENTILES) X(ARC_AT_LIMIT) \
+    X(LATENCY) X(LATENCY_HOPS) X(CHANNEL_BUSY) \
+    X(TITLE) X(NOW) X(LASTCLEAR) X(ELAPSED) X(TABLE) \
+    X(LOOPMAX) X(LOOPMAX_HTTP) X(CACHE_HITS) X(CACHE_MISSES)
+
+/// keyword ids, as stored in the token table
+enum PageKeyword : uint8_t {
+#define X(name) KW_##name,
+    PAGE_KEYWORDS(X)
+#undef X
+};
 
-/**
- * @brief Convert unsigned int to string
- */
-String utos( unsigned u )
-{
-    static char buf[10];
-    utoa(u,buf,10);
-    return String(buf);
-}
+/// keyword names, in the same order as `PageKeyword`
+constexpr const char* page_keywords[] = {
+#define X(name) #name,
+    PAGE_KEYWORDS(X)
+#undef X
+};
 
+static_assert( tmpl::isWellFormed(index_html), "unterminated %KEYWORD% in index_html" );
+static_assert( tmpl::hasOnlyKeywords(index_html,page_keywords), "unknown %KEYWORD% in index_html" );
 
-/**
- * @brief Generate one HTML table row, #of messages received from nodes (y)..(y+9)
- * 
- * @param y 
- * @return String 
- */
-String make_table_row(unsigned y, time_t nSecsElapsed)
-{
-    unsigned x, totalMsgsRx, MsgsPerHour, totalMsgsTx, totalRetries, success;
-
-    String s = "<tr><th>" + utos(y) + ":</td>";
-    for (x=0; x<10; x++) {
-
-        totalMsgsRx = nMessagesRx[y + x];
-        if (nSecsElapsed)
-            MsgsPerHour = (totalMsgsRx * 3600uL) / nSecsElapsed;
-        s += "<td>";
-        if (totalMsgsRx > 0) {
-            s += "<b>" + utos(totalMsgsRx) + "</b>";
-            if (nSecsElapsed)
-                s += "&ensp;<span class='mph'>" + utos(MsgsPerHour) + "/h</span>";
-        }
-        totalMsgsTx = nMessagesTx[y+x];
-        if (totalMsgsTx > 0) {
-            totalRetries = nRetries[y+x];
-            success = (100 * totalMsgsTx) / (totalMsgsTx + totalRetries);
-            s += "<br/><span class='suc'>" + utos(success) + "%</span>";
-        }
-        s += "</td>";
-    }
-    s += "</tr>\n";
-    return s;
-}
+/// index_html, split into literal text and keyword ids at compile time
+constexpr auto index_tokens = 
+    tmpl::tokenize<tmpl::countTokens(index_html)>(index_html,page_keywords);
+
+/// size of buffer for sending HTTP responses in chunks
+const size_t HTTP_CHUNK_SIZE = 512;
+
+/// statistics as seen by the HTTP task, taken at the start of each request
+static StatsSnapshot_t snap;
+
+/// last server-rendered page, re-used while statistics have not changed
+struct PageCache_t {
+    char* buf;              ///< rendered page, allocated on heap
+    size_t len;             ///< length of rendered page
+    size_t size;            ///< allocated size of `buf`
+    bool valid;             ///< false if never rendered or out of memory
+    uint32_t generation;    ///< `stats::generation()` when page was rendered
+    uint32_t liveness;      ///< `liveness::changes()` when page was rendered
+    unsigned long t_rendered; ///< millis() when page was rendered
+    uint32_t hits, misses;
+} pageCache;
+
+/// number of HTTP requests started
+volatile uint32_t httpRequests = 0;
+/// true while an HTTP request is being handled
+volatile bool httpBusy = false;
 
 
 /**
- * @brief Generate HTML table with statistics (# of messages received per node)
+ * @brief Generate HTML table with statistics (# of messages received per node).
  * 
- * @return String 
+ * @param out   the table is written to this
  */
-String make_table() 
+void make_table( TextWriter& out ) 
 {
-    String s;
-    unsigned x,y;
-    time_t nSecsElapsed = getTimeNow() - t_last_clear;
-
-    s = "<table><tr><th> </th>";
-    for (x=0; x<10; x++) s += "<th>&ensp;+" + utos(x) + "</th>";
-    s += "</tr>\n";
-    s += make_table_row(0,nSecsElapsed);
-    s += make_table_row(20,nSecsElapsed);
-    for (y=100; y<200; y+=10) {
-        s += make_table_row(y,nSecsElapsed);
-    }
-    s += "</table>";
-    return s;
+    table::render( out, snap, getTimeNow() - snap.t_last_clear );
 }
 
 
 /**
  * @brief Poor man's templating engine: replace keywords with content
  * 
- * @param var       the keyword that was enclosed in %...%
- * @return String   the replacement
+ * @param kw        the keyword that was enclosed in %...%, as resolved by the tokenizer
+ * @param out       the replacement is appended to this
  */
-String processor(const String& var)
+void processor( PageKeyword kw, TextWriter& out )
 {
-    if (var.length()==0) return "%";
-
+    switch (kw) {
     //----- static device information
-    if (var=="IPADDR") return ETH.localIP().toString();
-    if (var=="HOSTNAME") return ETH.getHostname();
-    if (var=="NODEID") return String(MY_NODE_ID);
-    if (var=="VERSION") return String(VERSION);
-    if (var=="PARENT") return String(transportGetParentNodeId());
+    case KW_IPADDR:     out.print( ETH.localIP().toString() ); break;
+    case KW_HOSTNAME:   out.print( ETH.getHostname() ); break;
+    case KW_NODEID:     out.print( unsigned(MY_NODE_ID) ); break;
+    case KW_VERSION:    out.print( VERSION ); break;
+    case KW_PARENT:     out.print( unsigned(transportGetParentNodeId()) ); break;
     //----- configuration
-    if (var=="POWER") return String(MY_RF24_PA_LEVEL);
-    if (var=="CHANNEL") return String(MY_RF24_CHANNEL);
+    case KW_POWER:      out.print( unsigned(MY_RF24_PA_LEVEL) ); break;
+    case KW_CHANNEL:    out.print( unsigned(MY_RF24_CHANNEL) ); break;
 
     //-----indication-based counts
     // # of messages received via network
-    if (var=="NRX") return String(rxtxStats.nRx);
+    case KW_NRX:        out.print( snap.rxtxStats.nRx ); break;
     // # of messages sent via network
-    if (var=="NTX") return String(rxtxStats.nTx);
+    case KW_NTX:        out.print( snap.rxtxStats.nTx ); break;
     // # of messages failed to send via network
-    if (var=="NERR") return String(rxtxStats.nErr);
+    case KW_NERR:       out.print( snap.rxtxStats.nErr ); break;
     // # of messages received from controller, as gateway
-    if (var=="NGWRX") return String(rxtxStats.nGwRx);
+    case KW_NGWRX:      out.print( snap.rxtxStats.nGwRx ); break;
     // # of messages sent to controller, as gateway
-    if (var=="NGWTX") return String(rxtxStats.nGwTx);
+    case KW_NGWTX:      out.print( snap.rxtxStats.nGwTx ); break;
     // percentage of messages attempted to send that could not be sent
-    if (var=="ERROR_RATE") return String( rxtxStats.nTx ? (100 * rxtxStats.nErr)/rxtxStats.nTx : 0 );
+    case KW_ERROR_RATE: out.print( snap.rxtxStats.nTx ? (100 * snap.rxtxStats.nErr)/snap.rxtxStats.nTx : 0 ); break;
 
     //----- ARC statistics
-    if (var=="PACKETS") return String(arcStats.packets);
-    if (var=="RETRIES") return String(arcStats.retries);
-    if (var=="SUCCESS") return String(arcStats.success);
+    case KW_PACKETS:    out.print( snap.arcStats.packets ); break;
+    case KW_RETRIES:    out.print( snap.arcStats.retries ); break;
+    case KW_SUCCESS:    out.print( snap.arcStats.success ); break;
+    case KW_ARC_PERCENTILES: {
+        stats::ArcPercentiles_t p = stats::arcPercentiles( snap.arcStats.histogram );
+        out.print( unsigned(p.p50) ); out.print("/"); 
+        out.print( unsigned(p.p95) ); out.print("/"); 
+        out.print( unsigned(p.max) );
+        break;
+    }
+    case KW_ARC_AT_LIMIT: out.print( unsigned(stats::arcPercentiles( snap.arcStats.histogram ).atLimit) ); break;
+    case KW_CHANNEL_BUSY: {
+        uint16_t busy[stats::NUM_WINDOWS];
+        airtime::utilization( busy );
+        for (unsigned w=0; w<stats::NUM_WINDOWS; w++) {
+            if (w) out.print("/");
+            out.print(unsigned(busy[w] / 10)); out.print("."); out.print(unsigned(busy[w] % 10));
+        }
+        break;
+    }
+    case KW_LATENCY: {
+        char buf[8];
+        latency::LatencySummary_t l = latency::summary();
+        formatMs( buf, sizeof buf, l.p50 ); out.print(buf); out.print("/");
+        formatMs( buf, sizeof buf, l.p95 ); out.print(buf); out.print("/");
+        formatMs( buf, sizeof buf, l.max ); out.print(buf);
+        break;
+    }
+    // same per next hop, like " (to 0: 0.2/1.0/3.1, to 12: ...)", empty if none
+    case KW_LATENCY_HOPS: {
+        char buf[8];
+        uint32_t hops[256/32];
+        bool first = true;
+        latency::hops( hops );
+        stats::forEachNode( hops, [&](unsigned id) {
+            latency::LatencySummary_t l = latency::hop( id );
+            out.print(first ? " (to " : ", to "); out.print(id); out.print(": ");
+            formatMs( buf, sizeof buf, l.p50 ); out.print(buf); out.print("/");
+            formatMs( buf, sizeof buf, l.p95 ); out.print(buf); out.print("/");
+            formatMs( buf, sizeof buf, l.max ); out.print(buf);
+            first = false;
+        });
+        if (!first) out.print(")");
+        break;
+    }
 
     //----- general information
-    if (var=="TITLE") return FRIENDLY_PROJECT_NAME ;
-    if (var=="NOW") {
+    case KW_TITLE:      out.print( FRIENDLY_PROJECT_NAME ); break;
+    case KW_NOW: {
         time_t epoch = getTimeNow();
         strftime(msgbuf, sizeof msgbuf, "%d.%m.%Y %H:%M:%S", localtime(&epoch));
-        return String(msgbuf);
-    }
-    if (var=="LASTCLEAR") {
-        strftime(msgbuf, sizeof msgbuf, "%d.%m.%Y %H:%M:%S", localtime(&t_last_clear));
-        return String(msgbuf);
+        out.print( msgbuf );
+        break;
     }
-    if (var=="ELAPSED") {
-        time_t t_elapsed = getTimeNow() - t_last_clear; // in seconds
+    case KW_LASTCLEAR:
+        strftime(msgbuf, sizeof msgbuf, "%d.%m.%Y %H:%M:%S", localtime(&snap.t_last_clear));
+        out.print( msgbuf );
+        break;
+    case KW_ELAPSED: {
+        time_t t_elapsed = getTimeNow() - snap.t_last_clear; // in seconds
         tm* te = gmtime(&t_elapsed);
         snprintf(msgbuf,sizeof msgbuf, "%dd %dh %dm", te->tm_yday, te->tm_hour, te->tm_min);
-        return String(msgbuf);
+        out.print( msgbuf );
+        break;
     }
+    //----- loop() timing since last report
+    case KW_LOOPMAX:    out.print( loopTiming[0].maxUs ); break;
+    case KW_LOOPMAX_HTTP: out.print( loopTiming[1].maxUs ); break;
+    case KW_CACHE_HITS: out.print( pageCache.hits ); break;
+    case KW_CACHE_MISSES: out.print( pageCache.misses ); break;
     //----- the biggie: table of messages vs node id
-    if (var=="TABLE") return make_table();
-    return String();
+    case KW_TABLE:      make_table(out); break;
+    }
 }
 
 
-#define CHAR_BEGIN_VAR '%'
-#define CHAR_END_VAR '%'
-
 /**
- * @brief Poor man's templating engine: find all keywords 
+ * @brief Poor man's templating engine: render a pre-tokenized template, 
+ * in a single pass without searching
  * 
  * @param tpl      the HTML with embedded keywords enclosed in %...%
- * @return String  final HTML
+ * @param tokens   the token table made from `tpl` by `tmpl::tokenize()`
+ * @param out      final HTML is written to this
+ */
+template<size_t NT>
+static void process( const char* tpl, const tmpl::TokenTable<NT>& tokens, TextWriter& out )
+{
+    for (const tmpl::Token& tok : tokens) {
+        if (tok.kind == tmpl::LITERAL)
+            out.write( tpl + tok.offset, tok.length );
+        else
+            processor( PageKeyword(tok.id), out );
+    }
+}
+
+
+/**
+ * @brief Flush function for TextWriter, sends one chunk of the HTTP response
+ */
+static void sendChunk( void* ctx, const char* data, size_t len )
+{
+    httpServer.sendContent( data, len );
+}
+
+
+/**
+ * @brief Send a response generated by a render function, using chunked transfer 
+ * encoding, so that RAM usage is bounded by one chunk buffer, not by the content size
+ * 
+ * @param contentType   MIME type of the response
+ * @param render        function that writes the response body
  */
-static String process( const String& tpl )
+static void sendChunked( const char* contentType, void (*render)(TextWriter&) )
 {
-    String res = "";
-    int p1,p2;
-
-    p1 = tpl.indexOf(CHAR_BEGIN_VAR);
-    p2 = 0;
-    while (p1 != -1) {
-        res += tpl.substring(p2,p1);
-        p2 = tpl.indexOf(CHAR_END_VAR,p1+1);
-        if (p2 != -1) {
-            res += processor( tpl.substring(p1+1,p2) );
+    uint32_t heapBefore = ESP.getFreeHeap();
+    char chunk[HTTP_CHUNK_SIZE];
+    TextWriter out( chunk, sizeof chunk, sendChunk );
+
+    httpServer.setContentLength( CONTENT_LENGTH_UNKNOWN );
+    httpServer.send( 200, contentType, "" );
+    render( out );
+    out.flush();
+    httpServer.sendContent( "" );   // terminating chunk
+
+    log_i("sent %u bytes, heap before:%u after:%u min:%u", 
+        (unsigned)out.total(), heapBefore, ESP.getFreeHeap(), ESP.getMinFreeHeap() );
+}
+
+
+/**
+ * @brief Flush function for TextWriter, appends data to the page cache, 
+ * growing the cache buffer as needed
+ */
+static void appendToCache( void* ctx, const char* data, size_t len )
+{
+    PageCache_t& cache = *(PageCache_t*)ctx;
+    if (!cache.valid) return;
+    if (cache.len + len > cache.size) {
+        size_t size = cache.len + len + 1024;
+        char* buf = (char*)realloc( cache.buf, size );
+        if (!buf) {
+            cache.valid = false;
+            return;
         }
-        p1 = tpl.indexOf(CHAR_BEGIN_VAR,p2+1);
-        p2++;
+        cache.buf = buf;
+        cache.size = size;
     }
-    res += tpl.substring(p2);
-    return res;
+    memcpy( cache.buf + cache.len, data, len );
+    cache.len += len;
+}
+
+
+/**
+ * @brief Send the server-rendered page. The page is only rendered again if 
+ * statistics or liveness of a node have changed and the cached copy is older 
+ * than PAGE_CACHE_MAX_AGE, or if it is older than PAGE_CACHE_MAX_IDLE (because 
+ * it also shows the time). A node can go offline without any message, so
+ * statistics alone do not tell.
+ */
+static void sendCachedPage()
+{
+    unsigned long age = millis() - pageCache.t_rendered;
+    bool hit = pageCache.valid && (
+        (age < PAGE_CACHE_MAX_AGE) ||
+        (age < PAGE_CACHE_MAX_IDLE && pageCache.generation == stats::generation()
+            && pageCache.liveness == liveness::changes()) );
+
+    if (hit) {
+        pageCache.hits++;
+    } else {
+        pageCache.misses++;
+        pageCache.liveness = liveness::changes();
+        stats::snapshot( snap );
+        pageCache.generation = snap.generation;
+        pageCache.t_rendered = millis();
+        pageCache.len = 0;
+        pageCache.valid = true;
+        char chunk[HTTP_CHUNK_SIZE];
+        TextWriter out( chunk, sizeof chunk, appendToCache, &pageCache );
+        process( index_html, index_tokens, out );
+        out.flush();
+    }
+
+    if (pageCache.valid) {
+        httpServer.setContentLength( pageCache.len );
+        httpServer.send( 200, "text/html", "" );
+        httpServer.sendContent( pageCache.buf, pageCache.len );
+    } else {
+        // not enough memory for the cache, so stream it directly
+        log_e("page cache: out of memory");
+        sendChunked( "text/html", [](TextWriter& out) { process(index_html,index_tokens,out); } );
+    }
+}
+
+
+/**
+ * @brief Write distribution of retries as comma-separated p50,p95,max,atLimit
+ */
+static void print_percentiles( TextWriter& out, const stats::ArcPercentiles_t& p )
+{
+    out.print(unsigned(p.p50)); out.print(",");
+    out.print(unsigned(p.p95)); out.print(",");
+    out.print(unsigned(p.max)); out.print(",");
+    out.print(unsigned(p.atLimit));
+}
+
+
+/**
+ * @brief Generate JSON object with all statistics counters. Per-node entries 
+ * are only included for nodes with non-zero counts, `seen` is the number of 
+ * seconds since the last message from or to the node, `dup` the number of 
+ * duplicates received, which are not included in `rx`. `windows` has the span in 
+ * seconds of the last minute/hour/day windows, and `win` of each node has
+ * [rx,tx,retries,success] for each of these windows. `arc` of each node has 
+ * [p50,p95,max,atLimit] of the retries required. `latency` has the time 
+ * forwarded messages spent in this device in us, and `hops` has 
+ * [id,p50,p95,max] for each next hop. `airtime` has the estimated share of 
+ * time the channel was busy in each window in 0.1%, and `air` of each node is 
+ * its share of the airtime since last clear in 0.1%. `live` of each node has 
+ * [state,interval,timeout], with state 0=learning, 1=online, 2=offline, and
+ * times in seconds. `offline` is the number of nodes that are offline.
+ * 
+ * @param out   the JSON is written to this
+ */
+void make_json_stats( TextWriter& out )
+{
+    out.print("{\"gen\":"); out.print(snap.generation);
+    out.print(",\"now\":"); out.print(unsigned(getTimeNow()));
+    out.print(",\"lastClear\":"); out.print(unsigned(snap.t_last_clear));
+    out.print(",\"rxtx\":{\"rx\":"); out.print(snap.rxtxStats.nRx);
+    out.print(",\"tx\":"); out.print(snap.rxtxStats.nTx);
+    out.print(",\"err\":"); out.print(snap.rxtxStats.nErr);
+    out.print(",\"gwRx\":"); out.print(snap.rxtxStats.nGwRx);
+    out.print(",\"gwTx\":"); out.print(snap.rxtxStats.nGwTx);
+    out.print("},\"arc\":{\"packets\":"); out.print(snap.arcStats.packets);
+    out.print(",\"retries\":"); out.print(snap.arcStats.retries);
+    out.print(",\"success\":"); out.print(snap.arcStats.success);
+    stats::ArcPercentiles_t p = stats::arcPercentiles( snap.arcStats.histogram );
+    out.print(",\"p50\":"); out.print(unsigned(p.p50));
+    out.print(",\"p95\":"); out.print(unsigned(p.p95));
+    out.print(",\"max\":"); out.print(unsigned(p.max));
+    out.print(",\"atLimit\":"); out.print(unsigned(p.atLimit));
+    out.print(",\"histogram\":[");
+    for (unsigned i=0; i<16; i++) {
+        if (i) out.print(",");
+        out.print(snap.arcStats.histogram[i]);
+    }
+    latency::LatencySummary_t l = latency::summary();
+    out.print("]},\"latency\":{\"n\":"); out.print(l.n);
+    out.print(",\"p50\":"); out.print(l.p50);
+    out.print(",\"p95\":"); out.print(l.p95);
+    out.print(",\"max\":"); out.print(l.max);
+    out.print(",\"late\":"); out.print(latency::late());
+    out.print(",\"hops\":[");
+    uint32_t hops[256/32];
+    latency::hops( hops );
+    bool firstHop = true;
+    stats::forEachNode( hops, [&](unsigned id) {
+        latency::LatencySummary_t h = latency::hop(id);
+        out.print(firstHop ? "[" : ",["); out.print(id);
+        out.print(","); out.print(h.p50);
+        out.print(","); out.print(h.p95);
+        out.print(","); out.print(h.max);
+        out.print("]");
+        firstHop = false;
+    });
+    uint16_t busy[stats::NUM_WINDOWS];
+    airtime::utilization( busy );
+    uint64_t airTotal = airtime::total();
+    out.print("]},\"airtime\":{\"busy\":[");
+    for (unsigned w=0; w<stats::NUM_WINDOWS; w++) {
+        if (w) out.print(",");
+        out.print(unsigned(busy[w]));
+    }
+    out.print("],\"ms\":"); out.print(unsigned(airTotal / 1000));
+    uint32_t offline[256/32];
+    out.print("},\"offline\":"); out.print(liveness::offline( offline ));
+    out.print(",\"windows\":[");
+    for (unsigned w=0; w<stats::NUM_WINDOWS; w++) {
+        if (w) out.print(",");
+        out.print(stats::windowSpan( stats::Window(w) ));
+    }
+    out.print("],\"nodes\":[");
+    bool first = true;
+    stats::forEachNode( snap.active, [&](unsigned id) {
+        stats::WindowStats_t win[stats::NUM_WINDOWS];
+        stats::windows( id, win );
+        const NodeCounters_t& node = snap.nodes[id];
+        liveness::NodeLiveness_t live = liveness::node(id);
+        if (!stats::hasCounts( node ) && win[stats::DAY].rx == 0 && win[stats::DAY].tx == 0
+            && live.state != liveness::OFFLINE) return;
+        out.print(first ? "{\"id\":" : ",{\"id\":"); out.print(id);
+        out.print(",\"rx\":"); out.print(node.rx);
+        out.print(",\"tx\":"); out.print(node.tx);
+        out.print(",\"retries\":"); out.print(node.retries);
+        out.print(",\"dup\":"); out.print(node.dups);
+        out.print(",\"seen\":"); out.print(stats::secondsSinceSeen(id));
+        out.print(",\"live\":["); out.print(unsigned(live.state));
+        out.print(","); out.print(live.interval);
+        out.print(","); out.print(live.timeout);
+        out.print("]");
+        out.print(",\"air\":"); out.print(airTotal ? unsigned(airtime::node(id) * 1000 / airTotal) : 0u);
+        out.print(",\"arc\":["); print_percentiles( out, stats::nodeArcPercentiles(id) );
+        out.print("],\"win\":[");
+        for (unsigned w=0; w<stats::NUM_WINDOWS; w++) {
+            out.print(w ? ",[" : "["); out.print(win[w].rx);
+            out.print(","); out.print(win[w].tx);
+            out.print(","); out.print(win[w].retries);
+            out.print(","); out.print(stats::arcSuccess( win[w].tx, win[w].retries ));
+            out.print("]");
+        }
+        out.print("]}");
+        first = false;
+    });
+    out.print("]}");
 }
 
 
+/**
+ * @brief Write one metric family with a single value, in Prometheus text format
+ */
+static void write_metric( TextWriter& out, const char* name, const char* type, const char* help, unsigned value )
+{
+    out.print("# HELP "); out.print(name); out.print(" "); out.print(help);
+    out.print("\n# TYPE "); out.print(name); out.print(" "); out.print(type);
+    out.print("\n"); out.print(name); out.print(" "); out.print(value); out.print("\n");
+}
+
+
+/**
+ * @brief Write one metric family with a value per node id, in Prometheus text format.
+ * Only nodes with non-zero values are included.
+ */
+static void write_node_metric( TextWriter& out, const char* name, const char* help, 
+    const StatsSnapshot_t& totals, unsigned NodeCounters_t::* counter )
+{
+    out.print("# HELP "); out.print(name); out.print(" "); out.print(help);
+    out.print("\n# TYPE "); out.print(name); out.print(" counter\n");
+    stats::forEachNode( totals.active, [&](unsigned id) {
+        unsigned value = totals.nodes[id].*counter;
+        if (value == 0) return;
+        out.print(name); out.print("{node_id=\""); out.print(id); out.print("\"} ");
+        out.print(value); out.print("\n");
+    });
+}
+
+
+/**
+ * @brief Generate statistics in Prometheus text exposition format. Uses the 
+ * totals since startup, which are never cleared, so `rate()` works.
+ * 
+ * @param out   the metrics are written to this
+ */
+void make_metrics( TextWriter& out )
+{
+    // only used by the HTTP task, like `snap`, so re-use its buffer
+    StatsSnapshot_t& totals = snap;
+    stats::totals( totals );
+
+    write_metric( out, "mysensors_rx_total", "counter", 
+        "Messages received via network", totals.rxtxStats.nRx );
+    write_metric( out, "mysensors_tx_total", "counter", 
+        "Messages sent via network", totals.rxtxStats.nTx );
+    write_metric( out, "mysensors_tx_errors_total", "counter", 
+        "Messages that could not be sent via network", totals.rxtxStats.nErr );
+    write_metric( out, "mysensors_gateway_rx_total", "counter", 
+        "Messages received from controller", totals.rxtxStats.nGwRx );
+    write_metric( out, "mysensors_gateway_tx_total", "counter", 
+        "Messages sent to controller", totals.rxtxStats.nGwTx );
+    write_metric( out, "mysensors_arc_packets_total", "counter", 
+        "Packets sent by RF24 radio", totals.arcStats.packets );
+    write_metric( out, "mysensors_arc_retries_total", "counter", 
+        "Automatic retries required by RF24 radio", totals.arcStats.retries );
+    write_node_metric( out, "mysensors_node_rx_total", 
+        "Messages received from node", totals, &NodeCounters_t::rx );
+    write_node_metric( out, "mysensors_node_tx_total", 
+        "Messages sent to node as next hop", totals, &NodeCounters_t::tx );
+    write_node_metric( out, "mysensors_node_retries_total", 
+        "Automatic retries required for messages sent to node", totals, &NodeCounters_t::retries );
+    write_node_metric( out, "mysensors_node_duplicates_total", 
+        "Duplicate messages received from node", totals, &NodeCounters_t::dups );
+}
+
+
+/**
+ * @brief Generate JSON object with device information, for the web UI shell
+ * 
+ * @param out   the JSON is written to this
+ */
+void make_json_info( TextWriter& out )
+{
+    out.print("{\"title\":\"" FRIENDLY_PROJECT_NAME "\",\"ip\":\""); 
+    out.print(ETH.localIP().toString());
+    out.print("\",\"hostname\":\""); out.print(ETH.getHostname());
+    out.print("\",\"channel\":"); out.print(unsigned(MY_RF24_CHANNEL));
+    out.print(",\"power\":"); out.print(unsigned(MY_RF24_PA_LEVEL));
+    out.print(",\"nodeId\":"); out.print(unsigned(MY_NODE_ID));
+    out.print(",\"parent\":"); out.print(unsigned(transportGetParentNodeId()));
+#ifdef OPERATE_AS_GATEWAY
+    out.print(",\"gateway\":true");
+#else
+    out.print(",\"gateway\":false");
+#endif
+    out.print(",\"loopMax\":"); out.print(loopTiming[0].maxUs);
+    out.print(",\"loopMaxHttp\":"); out.print(loopTiming[1].maxUs);
+    out.print(",\"cacheHits\":"); out.print(pageCache.hits);
+    out.print(",\"cacheMisses\":"); out.print(pageCache.misses);
+    radio::QueueStats_t qs;
+    radio::queueStats( qs );
+    out.print(",\"radioQueue\":{\"pushed\":"); out.print(qs.pushed);
+    out.print(",\"dropped\":"); out.print(qs.dropped);
+    out.print(",\"maxDepth\":"); out.print(qs.maxDepth);
+    out.print("}");
+    out.print(",\"idle\":"); out.print(sched::idlePermille());
+    out.print(",\"cpu\":{\"method\":\""); out.print(cpuload::method());
+    out.print("\",\"cores\":[");
+    for (unsigned i=0; i<cpuload::numCores(); i++) {
+        cpuload::CoreLoad_t c;
+        cpuload::core( i, c );
+        out.print(i ? ",[" : "["); out.print(c.now);
+        out.print(","); out.print(c.avg); out.print("]");
+    }
+    out.print("],\"tasks\":[");
+    {
+        cpuload::TaskLoad_t tasks[16];
+        unsigned n = cpuload::tasks( tasks, sizeof tasks / sizeof tasks[0] );
+        for (unsigned i=0; i<n; i++) {
+            const cpuload::TaskLoad_t& t = tasks[i];
+            out.print(i ? ",[\"" : "[\""); out.print(t.name);
+            out.print("\","); if (t.core < 0) out.print("-1"); else out.print(unsigned(t.core));
+            out.print(","); out.print(t.avg); out.print("]");
+        }
+    }
+    out.print("]}");
+    const persist::CheckpointStats_t& cp = persist::checkpointStats();
+    out.print(",\"checkpoints\":{\"n\":"); out.print(cp.n);
+    out.print(",\"skipped\":"); out.print(cp.skipped);
+    out.print(",\"bytes\":"); out.print(cp.bytes);
+    out.print(",\"lastUs\":"); out.print(cp.lastUs);
+    out.print(",\"maxUs\":"); out.print(cp.maxUs);
+    out.print("}");
+    out.print(",\"version\":\"" SVN_REV "\"}");
+}
+
+
+/**
+ * @brief Generate web page with time spent in subsystems, with a histogram 
+ * for each section. Times include the profiler overhead shown at the bottom.
+ * 
+ * @param out   the HTML is written to this
+ */
+void make_profile( TextWriter& out )
+{
+    out.print("<!DOCTYPE HTML><html><head><title>Profile</title>"
+        "<style>body { background-color: #cccccc; font-family: Arial, Helvetica, Sans-Serif; Color: #000088; }"
+        " table { border-collapse: collapse; } td, th { text-align: right; border: 1px solid #777777; padding: 4px; }"
+        "</style></head><body><h2>" FRIENDLY_PROJECT_NAME " profile</h2>\n"
+        "<table><tr><th>section</th><th>n</th><th>avg &micro;s</th><th>max</th><th>max ever</th>");
+    // skip the lowest buckets, below 4 us everything is noise
+    const unsigned firstBucket = 2;
+    for (unsigned i=firstBucket; i<profile::NUM_BUCKETS; i++) {
+        out.print(i < profile::NUM_BUCKETS-1 ? "<th>&lt;" : "<th>&ge;");
+        out.print(profile::bucketLimit( i < profile::NUM_BUCKETS-1 ? i : i-1 ));
+        out.print("</th>");
+    }
+    out.print("</tr>\n");
+    for (unsigned s=0; s<profile::NUM_SECTIONS; s++) {
+        profile::SectionStats_t st;
+        profile::read( profile::Section(s), st );
+        out.print("<tr><th>"); out.print(profile::name( profile::Section(s) ));
+        out.print("</th><td>"); out.print(st.n);
+        out.print("</td><td>"); out.print(st.n ? unsigned(st.sumUs / st.n) : 0u);
+        out.print("</td><td>"); out.print(st.maxUs);
+        out.print("</td><td>"); out.print(st.maxEverUs);
+        out.print("</td>");
+        for (unsigned i=firstBucket; i<profile::NUM_BUCKETS; i++) {
+            unsigned n = st.histogram[i];
+            // fold the lowest buckets into the first one shown
+            if (i == firstBucket) 
+                for (unsigned k=0; k<firstBucket; k++) n += st.histogram[k];
+            out.print("<td>");
+            if (n) out.print(n);
+            out.print("</td>");
+        }
+        out.print("</tr>\n");
+    }
+    out.print("</table><p>max is since last hourly report. Profiler overhead per measurement: ");
+    out.print(profile::overheadNs());
+    out.print(" ns</p><p><a href=\"/\">back</a></p></body></html>");
+}
+
+
+/// parameters of current /api/top request
+static unsigned topCount;
+static int topNode;
+
+/**
+ * @brief Generate JSON object with top talkers, i.e. node/sensor/command/type
+ * combinations with the most messages received since last clear. If `topNode` 
+ * is a node id, all entries for that node are listed instead. `err` is the 
+ * count of a rarer entry that was evicted, so `n` may be too high by that much.
+ * 
+ * @param out   the JSON is written to this
+ */
+void make_json_top( TextWriter& out )
+{
+    static traffic::TrafficEntry_t entries[TRAFFIC_TOP > 32 ? TRAFFIC_TOP : 32];
+    const unsigned size = sizeof entries / sizeof entries[0];
+    unsigned n = (topNode >= 0) 
+        ? traffic::node( topNode, entries, size ) 
+        : traffic::top( entries, topCount < size ? topCount : size );
+    traffic::CommandTotals_t totals;
+    traffic::commands( totals );
+
+    out.print("{\"slots\":"); out.print(unsigned(TRAFFIC_SLOTS));
+    out.print(",\"used\":"); out.print(traffic::used());
+    out.print(",\"evictions\":"); out.print(traffic::evictions());
+    out.print(",\"commands\":{");
+    for (unsigned c=0; c<5; c++) {
+        out.print(c ? ",\"" : "\""); out.print(traffic::commandName(c));
+        out.print("\":{\"n\":"); out.print(totals.count[c]);
+        out.print(",\"bytes\":"); out.print(totals.bytes[c]);
+        out.print("}");
+    }
+    out.print("},\"top\":[");
+    for (unsigned i=0; i<n; i++) {
+        const traffic::TrafficEntry_t& e = entries[i];
+        out.print(i ? ",{\"node\":" : "{\"node\":"); out.print(unsigned(e.node));
+        out.print(",\"sensor\":"); out.print(unsigned(e.sensor));
+        out.print(",\"cmd\":\""); out.print(traffic::commandName(e.command));
+        out.print("\",\"type\":"); out.print(unsigned(e.type));
+        out.print(",\"n\":"); out.print(e.count);
+        out.print(",\"bytes\":"); out.print(e.bytes);
+        out.print(",\"err\":"); out.print(e.error);
+        out.print("}");
+    }
+    out.print("]}");
+}
+
+
+/**
+ * @brief Generate JSON with stack high-water marks of all tasks and recent heap samples,
+ * for /api/health
+ * 
+ * @param out   where to write the JSON text
+ */
+void make_json_health( TextWriter& out )
+{
+    static health::HeapSample_t samples[HEALTH_HISTORY];
+    static health::TaskStack_t stacks[HEALTH_MAX_TASKS];
+    unsigned n = health::history( samples, HEALTH_HISTORY );
+
+    out.print("{\"interval\":"); out.print(unsigned(HEALTH_INTERVAL / 1000));
+    out.print(",\"limits\":{\"stack\":"); out.print(unsigned(HEALTH_MIN_STACK));
+    out.print(",\"free\":"); out.print(unsigned(HEALTH_MIN_FREE_HEAP));
+    out.print(",\"frag\":"); out.print(unsigned(HEALTH_MAX_FRAGMENTATION));
+    out.print("},\"dropped\":"); out.print(health::dropped());
+    if (n) {
+        const health::HeapSample_t& s = samples[n-1];
+        out.print(",\"heap\":{\"free\":"); out.print(s.free);
+        out.print(",\"largest\":"); out.print(s.largest);
+        out.print(",\"minFree\":"); out.print(s.minFree);
+        out.print(",\"frag\":"); out.print(unsigned(s.fragmentation));
+        out.print("}");
+    }
+    out.print(",\"stacks\":[");
+    unsigned nt = health::stacks( stacks, HEALTH_MAX_TASKS );
+    for (unsigned i=0; i<nt; i++) {
+        out.print(i ? ",[\"" : "[\""); out.print(stacks[i].name);
+        out.print("\","); out.print(stacks[i].free); out.print("]");
+    }
+    // [t,free,largest,minFree,frag,minStack], oldest first
+    out.print("],\"history\":[");
+    for (unsigned i=0; i<n; i++) {
+        const health::HeapSample_t& s = samples[i];
+        out.print(i ? ",[" : "["); out.print(s.t);
+        out.print(","); out.print(s.free);
+        out.print(","); out.print(s.largest);
+        out.print(","); out.print(s.minFree);
+        out.print(","); out.print(unsigned(s.fragmentation));
+        out.print(","); out.print(unsigned(s.minStack));
+        out.print("]");
+    }
+    out.print("]}");
+}
+
+
+/**
+ * @brief Make ETag for current state of statistics counters. Includes time of 
+ * last clear and a random boot id, so that generation numbers are not confused 
+ * across reboots, the current rolling window bucket, and the change counters
+ * of liveness and airtime, which are also in /api/stats: a node can go offline
+ * without any message.
+ */
+static String statsETag()
+{
+    // statistics survive reboots, but generation numbers start over
+    static const uint32_t bootId = esp_random() & 0xFFFF;
+    char etag[64];
+    unsigned clear = unsigned(stats::lastClear());
+    unsigned gen = stats::generation();
+    // rolling windows change when buckets expire, even without new messages
+    unsigned bucket = millis() / (60000uL / STATS_WINDOW_BUCKETS);
+    snprintf( etag, sizeof etag, "\"%x-%x-%x-%x-%x-%x\"", clear, unsigned(bootId), gen, bucket,
+        unsigned(liveness::changes()), unsigned(airtime::changes()) );
+    return String(etag);
+}
+
+
+/**
+ * @brief Register a handler for GET requests, which also keeps track of 
+ * HTTP activity for the loop() timing statistics
+ */
+static void onGet( const char* uri, WebServer::THandlerFunction handler )
+{
+    httpServer.on( uri, HTTP_GET, [handler]() {
+        httpRequests++;
+        httpBusy = true;
+        handler();
+        httpBusy = false;
+    });
+}
+
+
+/// connections of /events subscribers
+static WiFiClient sseClients[SSE_MAX_CLIENTS];
+
+
+/**
+ * @brief Accept a new /events subscriber. The connection is taken over from 
+ * WebServer and kept open, to push changes as Server-Sent Events
+ */
+static void subscribeEvents()
+{
+    WiFiClient client = httpServer.client();
+    for (WiFiClient& c : sseClients) {
+        if (!c.connected()) {
+            client.print(
+                "HTTP/1.1 200 OK\r\n"
+                "Content-Type: text/event-stream\r\n"
+                "Cache-Control: no-cache\r\n"
+                "Connection: keep-alive\r\n\r\n"
+                "retry: 5000\n\n");
+            c = client;
+            // new subscriber may have missed earlier changes, so send all active nodes next time
+            stats::markActiveDirty();
+            log_i("SSE client subscribed");
+            return;
+        }
+    }
+    httpServer.send(503, "text/plain", "too many subscribers");
+}
+
+
+/**
+ * @brief Flush function for TextWriter, sends data to all /events subscribers
+ */
+static void sendToSubscribers( void* ctx, const char* data, size_t len )
+{
+    for (WiFiClient& c : sseClients) {
+        if (c.connected() && c.write(data, len) != len) {
+            log_i("SSE client dropped");
+            c.stop();
+        }
+    }
+}
+
+
+/**
+ * @brief Push changed counters to all /events subscribers, as one SSE message.
+ * Contains global counters, and values for all nodes that have changed since 
+ * the last push, so the effort is proportional to the number of changed nodes.
+ * Call this periodically.
+ */
+static void pushEvents()
+{
+    static unsigned long t_lastPush = 0, t_lastSent = 0;
+    static uint32_t lastGeneration = 0;
+
+    unsigned long t_now = millis();
+    if ((unsigned long)(t_now - t_lastPush) < SSE_INTERVAL) return;
+    t_lastPush = t_now;
+
+    bool anyClient = false;
+    for (WiFiClient& c : sseClients) anyClient = anyClient || c.connected();
+    if (!anyClient) return;
+
+    uint32_t generation = stats::generation();
+    if (generation == lastGeneration) {
+        if ((unsigned long)(t_now - t_lastSent) > SSE_KEEPALIVE) {
+            sendToSubscribers( nullptr, ":\n\n", 3 );   // comment, to detect dead connections
+            t_lastSent = t_now;
+        }
+        return;
+    }
+
+    uint32_t dirty[256/32];
+    RxTxStats_t rxtx;
+    ArcStats_t arc;
+    stats::takeDirty( dirty );
+    stats::globals( rxtx, arc );
+    time_t lastClear = stats::lastClear();
+    lastGeneration = generation;
+
+    char chunk[HTTP_CHUNK_SIZE];
+    TextWriter out( chunk, sizeof chunk, sendToSubscribers );
+    out.print("data: {\"now\":"); out.print(unsigned(getTimeNow()));
+    out.print(",\"lastClear\":"); out.print(unsigned(lastClear));
+    out.print(",\"rx\":"); out.print(rxtx.nRx);
+    out.print(",\"tx\":"); out.print(rxtx.nTx);
+    out.print(",\"err\":"); out.print(rxtx.nErr);
+    out.print(",\"gwRx\":"); out.print(rxtx.nGwRx);
+    out.print(",\"gwTx\":"); out.print(rxtx.nGwTx);
+    out.print(",\"arc\":["); out.print(arc.packets);
+    out.print(","); out.print(arc.retries);
+    out.print(","); out.print(arc.success);
+    out.print(","); print_percentiles( out, stats::arcPercentiles(arc.histogram) );
+    out.print("],\"nodes\":[");
+    bool first = true;
+    stats::forEachNode( dirty, [&](unsigned id) {
+        NodeCounters_t node = stats::node( id );
+        out.print(first ? "[" : ",["); out.print(id);
+        out.print(","); out.print(node.rx);
+        out.print(","); out.print(node.tx);
+        out.print(","); out.print(node.retries);
+        out.print(","); print_percentiles( out, stats::nodeArcPercentiles(id) );
+        out.print("]");
+        first = false;
+    });
+    out.print("]}\n\n");
+    out.flush();
+    t_lastSent = t_now;
+}
+
+
+/**
+ * @brief The HTTP server runs in its own task, so slow clients don't delay loop()
+ */
+static void httpTask( void* )
+{
+    for (;;) {
+        {
+            profile::Scope p( profile::HTTP );
+            httpServer.handleClient();
+        }
+        {
+            profile::Scope p( profile::EVENTS );
+            pushEvents();
+        }
+        vTaskDelay(1);
+    }
+}
+
+
+/// request headers that WebServer should keep for us
+static const char* collected_headers[] = { "If-None-Match" };
+
+
  void setupHTTPServer()
  {
-    // Route for root / web page
-    httpServer.on( "/", HTTP_GET, []() {
+    httpServer.collectHeaders( collected_headers, sizeof(collected_headers)/sizeof(collected_headers[0]) );
+
+    // Route for root / web page: static shell, compressed, fetches data from /api/...
+    onGet( "/", []() {
         log_i("HTTP '/'");
-        httpServer.send(200, "text/html", process(index_html));
+        if (httpServer.header("If-None-Match") == INDEX_HTML_GZ_ETAG) {
+            httpServer.send(304);
+            return;
+        }
+        httpServer.sendHeader("Content-Encoding", "gzip");
+        httpServer.sendHeader("Cache-Control", "public, max-age=" SHELL_MAX_AGE);
+        httpServer.sendHeader("ETag", INDEX_HTML_GZ_ETAG);
+        httpServer.send_P( 200, "text/html", (const char*)index_html_gz, sizeof index_html_gz );
+    });
+    // server-rendered web page, for browsers without JavaScript
+    onGet( "/classic", []() {
+        log_i("HTTP '/classic'");
+        sendCachedPage();
+    });
+    // device information as JSON
+    onGet( "/api/info", []() {
+        sendChunked( "application/json", make_json_info );
+    });
+    // statistics as JSON, answer 304 if nothing changed since client's last request
+    onGet( "/api/stats", []() {
+        String etag = statsETag();
+        if (httpServer.header("If-None-Match") == etag) {
+            httpServer.send(304);
+            return;
+        }
+        stats::snapshot( snap );
+        httpServer.sendHeader("ETag", etag);
+        httpServer.sendHeader("Cache-Control", "no-cache");
+        sendChunked( "application/json", make_json_stats );
+    });
+    // time spent in subsystems
+    onGet( "/profile", []() {
+        sendChunked( "text/html", make_profile );
+    });
+    // top talkers as JSON, /api/top?n=10 or /api/top?node=42
+    onGet( "/api/top", []() {
+        topCount = httpServer.hasArg("n") ? httpServer.arg("n").toInt() : 10;
+        topNode = httpServer.hasArg("node") ? httpServer.arg("node").toInt() : -1;
+        if (topNode > 255) topNode = -1;
+        sendChunked( "application/json", make_json_top );
     });
-    httpServer.on("/clear", HTTP_GET, [] () {
+    // stack and heap usage as JSON
+    onGet( "/api/health", []() {
+        sendChunked( "application/json", make_json_health );
+    });
+    // live updates of statistics, as Server-Sent Events
+    onGet( "/events", subscribeEvents );
+    // statistics for Prometheus, counters are never reset
+    onGet( "/metrics", []() {
+        sendChunked( "text/plain; version=0.0.4", make_metrics );
+    });
+    onGet( "/clear", [] () {
         log_i("HTTP '/clear'");
         initStats();
+        persist::requestCheckpoint();
+        sched::trigger( persistJobId );
         httpServer.sendHeader("Location", "/",true);  
         httpServer.send(302, "text/plain", "");
     });
-    httpServer.on("/reboot", HTTP_GET, [] () {
+    onGet( "/reboot", [] () {
         log_i("HTTP '/reboot'");
         httpServer.sendHeader("Location", "/",true);  
         httpServer.send(302, "text/plain", "");
+        persist::saveRtc();
         ESP.restart();
     });
     httpServer.onNotFound( [] () {
@@ -677,6 +1776,8 @@ static String process( const String& tpl )
     });
     // Start server
     httpServer.begin();
+    xTaskCreatePinnedToCore( httpTask, "http", HTTP_TASK_STACK_SIZE, nullptr, 
+        HTTP_TASK_PRIORITY, nullptr, HTTP_TASK_CORE );
  }
 #endif // USE_HTTP
 
@@ -764,6 +1865,10 @@ void presentation()
 	//              				    1...5...10...15...20...25 max payload
 	//				                    |   |    |    |    |    |
 	present(SENSOR_ID_ARC, S_CUSTOM, F("ARC stats (JSON)") );
+    delay(10);
+	present(SENSOR_ID_LATENCY, S_CUSTOM, F("Forward latency (JSON)") );
+    delay(10);
+	present(SENSOR_ID_LIVENESS, S_CUSTOM, F("Node liveness (JSON)") );
     delay(10);
     present(SENSOR_ID_CMND, S_INFO, F("Commands"));
     delay(10);
@@ -782,11 +1887,11 @@ void presentation()
 void indication( const indication_t ind )
 {
 	switch (ind) {
-		case INDICATION_TX:		rxtxStats.nTx++; break;
-		case INDICATION_RX: 	rxtxStats.nRx++; break;
-		case INDICATION_GW_TX:	rxtxStats.nGwTx++; break;
-		case INDICATION_GW_RX: 	rxtxStats.nGwRx++; break;
-		case INDICATION_ERR_TX:	rxtxStats.nErr++; break;
+		case INDICATION_TX:		stats::countRxTx( stats::TX ); break;
+		case INDICATION_RX: 	stats::countRxTx( stats::RX ); break;
+		case INDICATION_GW_TX:	stats::countRxTx( stats::GW_TX ); break;
+		case INDICATION_GW_RX: 	stats::countRxTx( stats::GW_RX ); break;
+		case INDICATION_ERR_TX:	stats::countRxTx( stats::ERR_TX ); break;
 		default: 				break;
 	}
 }
@@ -832,27 +1937,90 @@ void receive(const MyMessage &message)
  * Defined in my modified MySensors library, as a "weak" function, i.e. the library 
  * will call this if it is defined in user code, or else quietly ignore it.
  * 
+ * This runs in the transport path, so it only queues a record of the message,
+ * statistics are updated by `processRadioEvents()` in loop().
+ * 
  * @param message 
  */
  void previewMessage(const MyMessage &message) 
  {
-	nMessagesRx[ message.getSender() ]++;
+    profile::Scope p( profile::PREVIEW );
+    radio::RadioEvent_t ev;
+    ev.t = uint32_t(esp_timer_get_time());
+    ev.kind = radio::RECEIVED;
+    ev.sender = message.getSender();
+    ev.destination = message.getDestination();
+    ev.sensor = message.sensor;
+    ev.type = message.type;
+    ev.command = message.getCommand();
+    ev.length = message.getLength();
+    ev.hop = 0;
+    ev.arc = 0;
+    // payload is not queued, only its hash
+    ev.hash = dedup::hash( ev.sender, ev.sensor, ev.command, ev.type, message.getCustom(), ev.length );
+    if (radio::push( ev )) sched::wake();
  }
 
 //#endif
 
 
 /**
- * @brief Called immdiately after a message has been sent, so we can do ARC statistics
+ * @brief Called immdiately after a message has been sent, so we can do ARC statistics.
+ * Like `previewMessage()`, this only queues a record of the message.
  * 
  * @param nextRecipient     the immediate destination node id, may be final destination or repeater
  * @param message           reference to the message being sent
  */
 void aftertransportSend(const uint8_t nextRecipient, const MyMessage &message) 
 {
-    int arc = collectArcStatistics();
-    nMessagesTx[ nextRecipient ]++;
-    nRetries[ nextRecipient ] += arc;
+    profile::Scope p( profile::AFTER_SEND );
+    radio::RadioEvent_t ev;
+    ev.t = uint32_t(esp_timer_get_time());
+    ev.hash = 0;
+    ev.kind = radio::SENT;
+    ev.sender = message.getSender();
+    ev.destination = message.getDestination();
+    ev.sensor = message.sensor;
+    ev.type = message.type;
+    ev.command = message.getCommand();
+    ev.length = message.getLength();
+    ev.hop = nextRecipient;
+    ev.arc = lastSendRetries();
+    if (radio::push( ev )) sched::wake();
+}
+
+
+/**
+ * @brief Update all statistics from the records queued by `previewMessage()` 
+ * and `aftertransportSend()`. Call from loop().
+ * 
+ * Duplicates (a node sent the same message again, because the ACK was lost) 
+ * are counted separately and not as received messages. They still use airtime, 
+ * and are still forwarded, because the hook cannot stop the library.
+ */
+void processRadioEvents()
+{
+    profile::Scope p( profile::RADIO );
+    radio::RadioEvent_t ev;
+    // bounded, so a flood of messages cannot stall loop()
+    for (unsigned n=0; n < 2*RADIO_QUEUE_SIZE && radio::pop( ev ); n++) {
+        uint32_t key = latency::key( ev.sender, ev.destination, ev.sensor, ev.type );
+        if (ev.kind == radio::RECEIVED) {
+            liveness::seen( ev.sender );
+            airtime::received( ev.sender, ev.length, ev.destination != BROADCAST_ADDRESS );
+            if (ev.destination != getNodeId()) latency::received( key, ev.t );
+            if (dedup::isDuplicate( ev.hash, ev.t )) {
+                stats::countDuplicate( ev.sender );
+                continue;
+            }
+            stats::countReceived( ev.sender );
+            traffic::count( ev.sender, ev.sensor, ev.command, ev.type, ev.length );
+        } else {
+            stats::countSent( ev.hop, ev.arc );
+            airtime::sent( ev.hop, ev.length, ev.arc, ev.hop != BROADCAST_ADDRESS );
+            latency::forwarded( key, ev.hop, ev.t );
+        }
+    }
 }
 
 
@@ -899,6 +2067,152 @@ void reportTemperature()
 }
 
 #endif // #ifdef USE_DS18B20
+//---------------------------------------------------------------------
+#pragma endregion
+//=====================================================================
+#pragma region Periodic jobs
+
+#ifdef USE_DS18B20
+/// report module temperature
+static uint32_t temperatureJob( unsigned long t_now )
+{
+    profile::Scope p( profile::TEMPERATURE );
+    reportTemperature();
+    return REPORT_TEMPERATURE_INTERVAL;
+}
+#endif
+
+
+/// every now and then, report ARC statistics ("pseudo-RSSI")
+static uint32_t reportJob( unsigned long t_now )
+{
+    profile::Scope p( profile::REPORTS );
+    wait(1);
+    const char* arc = reportArcStatistics();
+    log_i("ARC: %s",arc);
+    arc = reportArcHistogram();
+    log_i("ARC: %s",arc);
+    const char* lat = reportLatency();
+    log_i("Latency: %s",lat);
+    reportLatencyHops();
+    const char* timing = reportLoopTiming();
+    log_i("%s",timing);
+    const char* checkpoints = persist::report();
+    log_i("%s",checkpoints);
+#ifdef USE_SYSLOG
+    syslog.log(LOG_INFO, timing);
+    syslog.log(LOG_INFO, checkpoints);
+#endif
+    reportCpuLoad();
+    reportProfile();
+    //initStats();
+    return MIN_REPORT_INTERVAL;
+}
+
+
+#ifdef USE_NTP
+static uint32_t ntpJob( unsigned long t_now )
+{
+    profile::Scope p( profile::NTP );
+    ntpClient.update();     // only asks the server when its own interval has passed
+    return HOUSEKEEPING_INTERVAL;
+}
+#endif
+
+
+/// keep statistics safe across resets
+static uint32_t persistJob( unsigned long t_now )
+{
+    profile::Scope p( profile::PERSIST );
+    persist::loop( t_now );
+    return HOUSEKEEPING_INTERVAL;
+}
+
+
+/// CPU load per core and task
+static uint32_t cpuloadJob( unsigned long t_now )
+{
+    profile::Scope p( profile::CPULOAD );
+    cpuload::sample();
+    return 1 SECONDS;
+}
+
+
+/// check stack and heap usage
+static uint32_t healthJob( unsigned long t_now )
+{
+    profile::Scope p( profile::HEALTH );
+    health::sample( t_now );
+    health::Warning_t w;
+    while (health::nextWarning( w ))
+        reportHealth( w );
+    return HEALTH_INTERVAL;
+}
+
+
+/// report nodes that went offline, or came back
+static uint32_t livenessJob( unsigned long t_now )
+{
+    profile::Scope p( profile::LIVENESS );
+    liveness::Event_t ev;
+    while (liveness::nextEvent( ev )) 
+        reportLiveness( ev );
+    return HOUSEKEEPING_INTERVAL;
+}
+
+
+#ifdef LED_BUILTIN
+/// blink LED for 50ms every ~1000ms
+static uint32_t ledJob( unsigned long t_now )
+{
+    unsigned t = t_now & 0x3FF; // count up to ~1000ms
+    if (t < 50) {
+        TURN_LED_ON;
+        return 50 - t;
+    }
+    TURN_LED_OFF;
+    return 0x400 - t;
+}
+#endif
+
+
+/// number of jobs that `setupJobs()` registers in this configuration
+const unsigned NUM_JOBS = 5     // report, persist, liveness, cpuload, health
+#ifdef USE_DS18B20
+    + 1
+#endif
+#ifdef USE_NTP
+    + 1
+#endif
+#ifdef LED_BUILTIN
+    + 1
+#endif
+    ;
+static_assert( NUM_JOBS <= SCHED_MAX_JOBS, "too many jobs, raise SCHED_MAX_JOBS" );
+
+
+/**
+ * @brief Register all periodic jobs, call at end of setup(). Count each job
+ * in NUM_JOBS, so that a configuration with too many jobs does not compile.
+ */
+void setupJobs()
+{
+#ifdef USE_DS18B20
+    sched::add( "temperature", temperatureJob, REPORT_TEMPERATURE_INTERVAL );
+#endif
+    sched::add( "report", reportJob, MIN_REPORT_INTERVAL );
+#ifdef USE_NTP
+    sched::add( "ntp", ntpJob, 0 );
+#endif
+    persistJobId = sched::add( "persist", persistJob, 0 );
+    sched::add( "liveness", livenessJob, 0 );
+    sched::add( "cpuload", cpuloadJob, 1 SECONDS );
+    sched::add( "health", healthJob, 0 );
+#ifdef LED_BUILTIN
+    sched::add( "led", ledJob, 0 );
+#endif
+}
+
 //---------------------------------------------------------------------
 #pragma endregion
 
@@ -1059,9 +2373,22 @@ void setup()
     log_i("initialized OTA");
 #endif
 
-//----- locally attached sensors
+//----- statistics, as saved before reset
 
-    initStats();
+    airtime::begin( RF24_DATARATE_KBPS, MY_RF24_ADDR_WIDTH );
+    profile::calibrate();
+    cpuload::begin();
+    log_i("profiler overhead %u ns", unsigned(profile::overheadNs()));
+
+    const char* restored = persist::restore( rtc_reset_reason );
+    if (restored) {
+        log_i("restored statistics from %s", restored);
+#ifdef USE_SYSLOG
+        syslog.logf( LOG_NOTICE, "restored statistics from %s", restored );
+#endif
+    } else {
+        initStats();
+    }
 
 //----- Temperature sensor
 
@@ -1075,6 +2402,12 @@ void setup()
 
     const char* arc = reportArcStatistics();
     log_i("ARC: %s",arc);
+    arc = reportArcHistogram();
+    log_i("ARC: %s",arc);
+    arc = reportLatency();
+    log_i("Latency: %s",arc);
+
+    setupJobs();
 
 	Serial.println("---------- end setup()");
     Serial.flush();
@@ -1084,45 +2417,45 @@ void setup()
 void loop() 
 {
     unsigned long t_now = millis();
- 
-#if defined( USE_HTTP) 
-    httpServer.handleClient();
+    int64_t t_start = esp_timer_get_time();
+#ifdef USE_HTTP
+    uint32_t nRequests = httpRequests;
+    bool withHttp = httpBusy;
 #endif
 
 #ifdef USE_OTA
-    ArduinoOTA.handle();
+    {
+        profile::Scope p( profile::OTA );
+        ArduinoOTA.handle();
+    }
 #endif
 
-#ifdef USE_NTP
-    ntpClient.update();
-#endif
+    // statistics for messages received and sent meanwhile
+    processRadioEvents();
 
-#ifdef USE_DS18B20
-    // report module temperature
-	static unsigned long t_lastTemperatureReport=0;
-	if ((unsigned long)(t_now - t_lastTemperatureReport) > REPORT_TEMPERATURE_INTERVAL) {
-		t_lastTemperatureReport=t_now;
-        reportTemperature();
-    }
-#endif
+    // temperature, reports, NTP, checkpoints, liveness, LED
+    uint32_t t_next = sched::run( t_now );
 
-    // every now and then, report ARC statistics ("pseudo-RSSI")
-	static unsigned long t_lastReport=0;
-	if ((unsigned long)(t_now - t_lastReport) > MIN_REPORT_INTERVAL) {
-		t_lastReport=t_now;
-        wait(1);
-        const char* arc = reportArcStatistics();
-        log_i("ARC: %s",arc);
-        //initStats();
-	}
+    // collect loop() iteration time, separately for iterations with concurrent HTTP requests
+    uint32_t t_loop = uint32_t(esp_timer_get_time() - t_start);
+#ifdef USE_HTTP
+    withHttp = withHttp || httpBusy || (httpRequests != nRequests);
+#else
+    bool withHttp = false;
+#endif
+    LoopTiming_t& lt = loopTiming[withHttp ? 1 : 0];
+    lt.n++;
+    lt.sumUs += t_loop;
+    if (t_loop > lt.maxUs) lt.maxUs = t_loop;
+    profile::record( profile::LOOP, t_loop );
 
-#ifdef LED_BUILTIN
-    // blink LED
-    static unsigned t_last_LED=0;
-	if ((unsigned long)(t_now - t_last_LED) > 50uL) {
-		t_last_LED=t_now;
-        unsigned t = t_now & 0x3FF; // count up to ~1000ms
-        if (t < 50) TURN_LED_ON; else TURN_LED_OFF;
-    }
+#ifdef MY_SEPARATE_PROCESS_TASK
+    // nothing to do until the next job is due, or a message arrives
+    sched::sleep( t_next < LOOP_MAX_SLEEP ? t_next : LOOP_MAX_SLEEP );
+#else
+    // with one task, MySensors polls the radio between loop() calls, so only
+    // sleep for a tick: enough to let the idle task run, short enough that the
+    // 3-message RX FIFO of the nRF24 does not overflow
+    sched::sleep( t_next < LOOP_POLL_SLEEP ? t_next : LOOP_POLL_SLEEP );
 #endif
 }
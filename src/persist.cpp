@@ -0,0 +1,285 @@
+/**
+ * @file 		  persist.cpp
+ *
+ * Project		: Home automation
+ * Author		: Bernd Waldmann
+ * Created		: 16-Oct-2026
+ * Tabsize		: 4
+ *
+ * This Revision: $Id$
+ */
+
+/*
+   Copyright (C) 2024 Bernd Waldmann
+
+   This Source Code Form is subject to the terms of the Mozilla Public License, v. 2.0.
+   If a copy of the MPL was not distributed with this file, You can obtain one at http://mozilla.org/MPL/2.0/
+
+   SPDX-License-Identifier: MPL-2.0
+*/
+
+#include <stddef.h>
+#include <Preferences.h>
+#include <esp_attr.h>
+#include <esp_rom_crc.h>
+#include <esp_timer.h>
+#include <rom/rtc.h>
+
+#include "stats.h"
+#include "persist.h"
+
+namespace persist {
+
+/// changes whenever the layout of the saved counters changes
+const uint32_t LAYOUT = 0x5354'0000 | sizeof(StatsCounters_t);
+
+/// copy of statistics in RTC memory, survives soft resets
+struct RtcBlock_t {
+    uint32_t layout;        ///< LAYOUT, 0 while being written
+    StatsSnapshot_t snap;
+    uint32_t crc;           ///< over all of the above, see `rtcCrc()`
+};
+
+static RTC_NOINIT_ATTR RtcBlock_t rtcBlock;
+
+/// serializes access to `rtcBlock` and NVS
+static StaticSemaphore_t mutexBuffer;
+static SemaphoreHandle_t mutex = xSemaphoreCreateMutexStatic( &mutexBuffer );
+
+//----- NVS layout: namespace "stats", keys "layout", "clear", "g" and "n0".."n15"
+
+static const char* NVS_NAMESPACE = "stats";
+
+/// number of nodes per NVS block
+const unsigned NODES_PER_BLOCK = 16;
+const unsigned NUM_NODE_BLOCKS = 256 / NODES_PER_BLOCK;
+
+/// CRC of each block as last written to or read from NVS, 0 if unknown.
+/// Block 0 holds the global counters, blocks 1.. hold node counters.
+static uint32_t blockCrc[1 + NUM_NODE_BLOCKS];
+
+static volatile bool checkpointRequested = false;
+static uint32_t checkpointGeneration = 0;
+static CheckpointStats_t cpStats;
+
+
+static inline uint32_t crc32( const void* data, size_t len )
+{
+    return esp_rom_crc32_le( 0, (const uint8_t*)data, len );
+}
+
+
+static uint32_t rtcCrc()
+{
+    uint32_t crc = crc32( &rtcBlock.layout, sizeof rtcBlock.layout );
+    return esp_rom_crc32_le( crc, (const uint8_t*)&rtcBlock.snap, sizeof rtcBlock.snap );
+}
+
+
+/// get NVS key, address and size of block `b` within `c`
+static const char* block( unsigned b, StatsCounters_t& c, void*& data, size_t& len )
+{
+    static char key[12];
+    if (b == 0) {
+        data = &c;
+        len = offsetof(StatsCounters_t, nodes);
+        return "g";
+    }
+    snprintf( key, sizeof key, "n%u", b-1 );
+    data = &c.nodes[(b-1) * NODES_PER_BLOCK];
+    len = NODES_PER_BLOCK * sizeof(NodeCounters_t);
+    return key;
+}
+
+
+static bool isZero( const void* data, size_t len )
+{
+    const uint8_t* p = (const uint8_t*)data;
+    for (size_t i=0; i<len; i++) 
+        if (p[i]) return false;
+    return true;
+}
+
+
+/**
+ * @brief Read counters from NVS into `rtcBlock.snap`
+ * 
+ * @return true if a checkpoint with the current layout was found
+ */
+static bool loadNvs()
+{
+    Preferences prefs;
+    if (!prefs.begin( NVS_NAMESPACE, true )) return false;
+    bool ok = (prefs.getUInt( "layout", 0 ) == LAYOUT);
+    StatsSnapshot_t& s = rtcBlock.snap;
+    memset( &s, 0, sizeof s );
+    if (ok) {
+        s.t_last_clear = prefs.getUInt( "clear", 0 );
+        for (unsigned b=0; b < 1 + NUM_NODE_BLOCKS; b++) {
+            void* data;
+            size_t len;
+            const char* key = block( b, s, data, len );
+            if (prefs.getBytes( key, data, len ) == len) 
+                blockCrc[b] = crc32( data, len );
+            else
+                memset( data, 0, len );
+        }
+    }
+    prefs.end();
+    return ok;
+}
+
+
+/**
+ * @brief Restore statistics saved before the last reset, from RTC memory if it
+ * survived, or else from the last NVS checkpoint. Call this early in `setup()`.
+ * 
+ * @param resetReason   as returned by `rtc_get_reset_reason(0)`
+ * @return const char*  where statistics were restored from, or nullptr if nothing was restored
+ */
+const char* restore( int resetReason )
+{
+    const char* source = nullptr;
+    xSemaphoreTake( mutex, portMAX_DELAY );
+    // RTC memory is random after power-on, and may be damaged after brown-out
+    bool rtcKept = (resetReason != POWERON_RESET && resetReason != RTCWDT_BROWN_OUT_RESET);
+    if (rtcKept && rtcBlock.layout == LAYOUT 
+        && rtcBlock.crc == rtcCrc()) {
+        source = "RTC";
+    } else if (loadNvs()) {
+        source = "NVS";
+    }
+    if (source) 
+        stats::restore( rtcBlock.snap, rtcBlock.snap.t_last_clear );
+    xSemaphoreGive( mutex );
+    return source;
+}
+
+
+static void saveRtcLocked()
+{
+    rtcBlock.layout = 0;
+    stats::snapshot( rtcBlock.snap );
+    rtcBlock.layout = LAYOUT;
+    rtcBlock.crc = rtcCrc();
+}
+
+
+/**
+ * @brief Copy current statistics to RTC memory. Call this before a restart.
+ */
+void saveRtc()
+{
+    xSemaphoreTake( mutex, portMAX_DELAY );
+    saveRtcLocked();
+    xSemaphoreGive( mutex );
+}
+
+
+/**
+ * @brief Write all blocks of counters that have changed since the last 
+ * checkpoint to NVS. Blocks of nodes that have never been active are not written.
+ */
+void checkpoint()
+{
+    int64_t t_start = esp_timer_get_time();
+    xSemaphoreTake( mutex, portMAX_DELAY );
+    saveRtcLocked();
+    StatsSnapshot_t& s = rtcBlock.snap;
+
+    Preferences prefs;
+    if (!prefs.begin( NVS_NAMESPACE, false )) {
+        xSemaphoreGive( mutex );
+        log_e("cannot open NVS namespace '%s'", NVS_NAMESPACE);
+        return;
+    }
+    unsigned nBlocks = 0, nBytes = 0;
+    if (prefs.getUInt( "layout", 0 ) != LAYOUT) {
+        prefs.clear();
+        prefs.putUInt( "layout", LAYOUT );
+        memset( blockCrc, 0, sizeof blockCrc );
+    }
+    if (prefs.getUInt( "clear", 0 ) != unsigned(s.t_last_clear)) {
+        prefs.putUInt( "clear", unsigned(s.t_last_clear) );
+        nBytes += sizeof(uint32_t);
+    }
+    for (unsigned b=0; b < 1 + NUM_NODE_BLOCKS; b++) {
+        void* data;
+        size_t len;
+        const char* key = block( b, s, data, len );
+        uint32_t crc = crc32( data, len );
+        if (crc == blockCrc[b]) continue;
+        if (blockCrc[b] == 0 && isZero( data, len ) && !prefs.isKey( key )) continue;
+        if (prefs.putBytes( key, data, len ) == len) {
+            blockCrc[b] = crc;
+            nBlocks++;
+            nBytes += len;
+        }
+    }
+    prefs.end();
+    checkpointGeneration = s.generation;
+    xSemaphoreGive( mutex );
+
+    uint32_t us = uint32_t(esp_timer_get_time() - t_start);
+    cpStats.n++;
+    cpStats.blocks += nBlocks;
+    cpStats.bytes += nBytes;
+    cpStats.lastUs = us;
+    if (us > cpStats.maxUs) cpStats.maxUs = us;
+    log_i("NVS checkpoint: %u blocks, %u bytes, %u us", nBlocks, nBytes, unsigned(us));
+}
+
+
+/**
+ * @brief Ask for a checkpoint at the next call of `loop()`, e.g. after clearing
+ */
+void requestCheckpoint()
+{
+    checkpointRequested = true;
+}
+
+
+/**
+ * @brief Refresh RTC copy and write NVS checkpoints when due. Call this from loop().
+ */
+void loop( unsigned long t_now )
+{
+    static unsigned long t_lastRtc = 0, t_lastNvs = 0;
+
+    if ((unsigned long)(t_now - t_lastNvs) > PERSIST_NVS_INTERVAL || checkpointRequested) {
+        t_lastNvs = t_now;
+        t_lastRtc = t_now;
+        checkpointRequested = false;
+        if (stats::generation() == checkpointGeneration) 
+            cpStats.skipped++;
+        else
+            checkpoint();
+    } else if ((unsigned long)(t_now - t_lastRtc) > PERSIST_RTC_INTERVAL) {
+        t_lastRtc = t_now;
+        saveRtc();
+    }
+}
+
+
+const CheckpointStats_t& checkpointStats()
+{
+    return cpStats;
+}
+
+
+/**
+ * @brief Report cost and frequency of NVS checkpoints since startup
+ * 
+ * @return const char*  pointer to report text
+ */
+const char* report()
+{
+    static char text[96];
+    snprintf( text, sizeof text, 
+        "NVS checkpoints: %u written, %u skipped, %u blocks, %u bytes, last/max %u/%u us",
+        unsigned(cpStats.n), unsigned(cpStats.skipped), unsigned(cpStats.blocks), 
+        unsigned(cpStats.bytes), unsigned(cpStats.lastUs), unsigned(cpStats.maxUs) );
+    return text;
+}
+
+} // namespace persist
@@ -0,0 +1,73 @@
+/**
+ * @file 		  persist.h
+ *
+ * Project		: Home automation
+ * Author		: Bernd Waldmann
+ * Created		: 16-Oct-2026
+ * Tabsize		: 4
+ *
+ * This Revision: $Id$
+ */
+
+/*
+   Copyright (C) 2024 Bernd Waldmann
+
+   This Source Code Form is subject to the terms of the Mozilla Public License, v. 2.0.
+   If a copy of the MPL was not distributed with this file, You can obtain one at http://mozilla.org/MPL/2.0/
+
+   SPDX-License-Identifier: MPL-2.0
+*/
+
+/**
+ * @brief Keep statistics since last clear across reboots.
+ *
+ * A copy of the counters is kept in RTC memory that is not initialized at 
+ * startup, protected by a CRC. It is refreshed every few seconds, and right 
+ * before a restart requested via web UI or OTA, so soft resets (restart, 
+ * watchdog, panic) lose almost nothing.
+ *
+ * To survive power loss, the counters are also checkpointed to NVS flash, by
+ * default once per hour. Counters are stored in blocks of 16 nodes, and only 
+ * blocks that have changed since the last checkpoint are written, which keeps 
+ * flash wear proportional to the number of active nodes.
+ */
+
+#ifndef _persist_h
+#define _persist_h
+
+#include <Arduino.h>
+
+/// [ms] how often the copy in RTC memory is refreshed
+#ifndef PERSIST_RTC_INTERVAL
+ #define PERSIST_RTC_INTERVAL   10000
+#endif
+
+/// [ms] how often changed counters are written to NVS
+#ifndef PERSIST_NVS_INTERVAL
+ #define PERSIST_NVS_INTERVAL   (60uL * 60 * 1000)
+#endif
+
+namespace persist {
+
+/// cost of NVS checkpoints since startup
+struct CheckpointStats_t {
+    uint32_t n;             ///< number of checkpoints written
+    uint32_t skipped;       ///< number of checkpoints skipped, because nothing changed
+    uint32_t blocks;        ///< number of blocks written, in total
+    uint32_t bytes;         ///< number of bytes written, in total
+    uint32_t lastUs;        ///< duration of last checkpoint
+    uint32_t maxUs;         ///< max duration of a checkpoint
+};
+
+const char* restore( int resetReason );
+void saveRtc();
+void checkpoint();
+void requestCheckpoint();
+void loop( unsigned long t_now );
+
+const CheckpointStats_t& checkpointStats();
+const char* report();
+
+} // namespace persist
+
+#endif // _persist_h
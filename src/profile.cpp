@@ -0,0 +1,146 @@
+/**
+ * @file 		  profile.cpp
+ *
+ * Project		: Home automation
+ * Author		: Bernd Waldmann
+ * Created		: 16-Oct-2026
+ * Tabsize		: 4
+ *
+ * This Revision: $Id$
+ */
+
+/*
+   Copyright (C) 2024 Bernd Waldmann
+
+   This Source Code Form is subject to the terms of the Mozilla Public License, v. 2.0.
+   If a copy of the MPL was not distributed with this file, You can obtain one at http://mozilla.org/MPL/2.0/
+
+   SPDX-License-Identifier: MPL-2.0
+*/
+
+#include "profile.h"
+#include "seqlock.h"
+
+namespace profile {
+
+/// statistics of one section, as measured on one core
+struct CoreSection {
+    volatile uint32_t seq;  ///< sequence lock, odd while being written
+    uint32_t period;        ///< value of `period` when `st.maxUs` was last reset
+    SectionStats_t st;
+};
+
+/// sections[c][s] is only written on core c, with interrupts masked, so
+/// there is exactly one writer and no lock shared between the cores.
+/// The extra section is scratch space for `calibrate()`.
+static CoreSection sections[portNUM_PROCESSORS][NUM_SECTIONS+1];
+static const Section CALIBRATE = Section(NUM_SECTIONS);
+
+/// advanced by `nextPeriod()`, writers reset their maximum when it changes
+static volatile uint32_t period;
+static uint32_t calibratedNs;
+
+
+/**
+ * @brief Add a measurement to a section. Usually called by `Scope`.
+ * Lock-free, so it can be used in the MySensors hooks.
+ */
+void record( Section s, uint32_t us )
+{
+    // bucket i counts times below 2^i us
+    unsigned i = us ? 32 - __builtin_clz( us ) : 0;
+    if (i >= NUM_BUCKETS) i = NUM_BUCKETS-1;
+    // no other task can run on this core until the record is complete
+    UBaseType_t irq = portSET_INTERRUPT_MASK_FROM_ISR();
+    CoreSection& cs = sections[xPortGetCoreID()][s];
+    uint32_t p = __atomic_load_n( &period, __ATOMIC_RELAXED );
+    beginWrite( cs.seq );
+    SectionStats_t& st = cs.st;
+    if (cs.period != p) {
+        st.maxUs = 0;
+        cs.period = p;
+    }
+    st.n++;
+    st.sumUs += us;
+    if (us > st.maxUs) st.maxUs = us;
+    if (us > st.maxEverUs) st.maxEverUs = us;
+    st.histogram[i]++;
+    endWrite( cs.seq );
+    portCLEAR_INTERRUPT_MASK_FROM_ISR( irq );
+}
+
+
+/**
+ * @brief Get a consistent copy of a section's statistics, summed over all cores
+ */
+void read( Section s, SectionStats_t& stats )
+{
+    stats = SectionStats_t{};
+    uint32_t p = __atomic_load_n( &period, __ATOMIC_RELAXED );
+    for (unsigned c=0; c<portNUM_PROCESSORS; c++) {
+        CoreSection& cs = sections[c][s];
+        SectionStats_t st;
+        uint32_t csPeriod, q;
+        do {
+            q = beginRead( cs.seq );
+            st = cs.st;
+            csPeriod = cs.period;
+        } while (!endRead( cs.seq, q ));
+        stats.n += st.n;
+        stats.sumUs += st.sumUs;
+        // a maximum from before the last nextPeriod() does not count
+        if (csPeriod == p && st.maxUs > stats.maxUs) stats.maxUs = st.maxUs;
+        if (st.maxEverUs > stats.maxEverUs) stats.maxEverUs = st.maxEverUs;
+        for (unsigned i=0; i<NUM_BUCKETS; i++) stats.histogram[i] += st.histogram[i];
+    }
+}
+
+
+/**
+ * @brief Start a new reporting period, i.e. reset the per-period maximum of all sections
+ */
+void nextPeriod()
+{
+    __atomic_fetch_add( &period, 1, __ATOMIC_RELAXED );
+}
+
+
+/**
+ * @brief Get name of a section, for reports
+ */
+const char* name( Section s )
+{
+    static const char* const names[NUM_SECTIONS] = {
+        "loop", "ota", "ntp", "temperature", "reports", "persist", "liveness",
+        "http", "events", "preview", "afterSend", "radio", "cpuload", "health"
+    };
+    return (s < NUM_SECTIONS) ? names[s] : "?";
+}
+
+
+/**
+ * @brief Measure the cost of a Scope, i.e. two calls of `esp_timer_get_time()`
+ * and one `record()`. Measurements go to a scratch section that is never reported.
+ */
+void calibrate()
+{
+    const unsigned N = 1000;
+    int64_t t0 = esp_timer_get_time();
+    for (unsigned i=0; i<N; i++) {
+        Scope p( CALIBRATE );
+    }
+    int64_t t1 = esp_timer_get_time();
+    calibratedNs = uint32_t((t1 - t0) * 1000 / N);
+}
+
+
+/**
+ * @brief Get the time that a Scope adds to the code it measures, in ns, as
+ * measured by `calibrate()`
+ */
+uint32_t overheadNs()
+{
+    return calibratedNs;
+}
+
+} // namespace profile
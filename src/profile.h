@@ -0,0 +1,103 @@
+/**
+ * @file 		  profile.h
+ *
+ * Project		: Home automation
+ * Author		: Bernd Waldmann
+ * Created		: 16-Oct-2026
+ * Tabsize		: 4
+ *
+ * This Revision: $Id$
+ */
+
+/*
+   Copyright (C) 2024 Bernd Waldmann
+
+   This Source Code Form is subject to the terms of the Mozilla Public License, v. 2.0.
+   If a copy of the MPL was not distributed with this file, You can obtain one at http://mozilla.org/MPL/2.0/
+
+   SPDX-License-Identifier: MPL-2.0
+*/
+
+/**
+ * @brief Time spent in subsystems of loop(), the HTTP task and the MySensors hooks.
+ *
+ * Wrap a call in a `profile::Scope` to measure it with `esp_timer_get_time()`:
+ *
+ *      { profile::Scope p( profile::OTA ); ArduinoOTA.handle(); }
+ *
+ * Each section has a histogram with power-of-2 buckets (bucket i counts times
+ * below 2^i us, the last one everything above), count and sum since startup,
+ * and the maximum since the last `nextPeriod()`, i.e. the last periodic report.
+ *
+ * Each core keeps its own copy of all sections, which `record()` updates with
+ * interrupts masked on that core and a sequence lock for readers, so it
+ * never waits for another core; `read()` sums up the copies.
+ *
+ * The cost of a Scope itself is measured by `calibrate()` and reported as
+ * `overheadNs()`; it is included in every measured time.
+ */
+
+#ifndef _profile_h
+#define _profile_h
+
+#include <Arduino.h>
+#include <esp_timer.h>
+
+namespace profile {
+
+enum Section : uint8_t {
+    LOOP,           ///< whole loop() iteration
+    OTA,            ///< ArduinoOTA.handle()
+    NTP,            ///< ntpClient.update()
+    TEMPERATURE,    ///< reportTemperature()
+    REPORTS,        ///< hourly statistics reports
+    PERSIST,        ///< persist::loop(), RTC and NVS checkpoints
+    LIVENESS,       ///< offline detection and reports
+    HTTP,           ///< httpServer.handleClient()
+    EVENTS,         ///< pushEvents() to SSE clients
+    PREVIEW,        ///< previewMessage() hook, for every received message
+    AFTER_SEND,     ///< aftertransportSend() hook, for every sent message
+    RADIO,          ///< statistics for queued radio events, in loop()
+    CPULOAD,        ///< cpuload::sample()
+    HEALTH,         ///< health::sample(), stack and heap monitor
+    NUM_SECTIONS
+};
+
+const unsigned NUM_BUCKETS = 20;
+
+/// statistics of one section
+struct SectionStats_t {
+    uint32_t n;             ///< number of measurements since startup
+    uint64_t sumUs;         ///< total time since startup
+    uint32_t maxUs;         ///< longest time since last `nextPeriod()`
+    uint32_t maxEverUs;     ///< longest time since startup
+    uint32_t histogram[NUM_BUCKETS];
+};
+
+void record( Section s, uint32_t us );
+void read( Section s, SectionStats_t& stats );
+void nextPeriod();
+const char* name( Section s );
+
+void calibrate();
+uint32_t overheadNs();
+
+/// upper bound of histogram bucket `i` in us
+inline uint32_t bucketLimit( unsigned i )
+{
+    return 1uL << i;
+}
+
+/// measures the time from construction to destruction
+class Scope {
+public:
+    Scope( Section s ) : _s(s), _t0(esp_timer_get_time()) {}
+    ~Scope() { record( _s, uint32_t(esp_timer_get_time() - _t0) ); }
+private:
+    Section _s;
+    int64_t _t0;
+};
+
+} // namespace profile
+
+#endif // _profile_h
@@ -0,0 +1,128 @@
+/**
+ * @file 		  radio_events.cpp
+ *
+ * Project		: Home automation
+ * Author		: Bernd Waldmann
+ * Created		: 16-Oct-2026
+ * Tabsize		: 4
+ *
+ * This Revision: $Id$
+ */
+
+/*
+   Copyright (C) 2024 Bernd Waldmann
+
+   This Source Code Form is subject to the terms of the Mozilla Public License, v. 2.0.
+   If a copy of the MPL was not distributed with this file, You can obtain one at http://mozilla.org/MPL/2.0/
+
+   SPDX-License-Identifier: MPL-2.0
+*/
+
+#include "radio_events.h"
+
+static_assert( (RADIO_QUEUE_SIZE & (RADIO_QUEUE_SIZE-1)) == 0, "RADIO_QUEUE_SIZE must be a power of 2" );
+
+namespace radio {
+
+/// single-producer/single-consumer ring, indexes count up and wrap around
+struct Ring {
+    TaskHandle_t owner;     ///< producer task, nullptr if unused
+    uint32_t head;          ///< next slot to write, written by producer only
+    uint32_t tail;          ///< next slot to read, written by consumer only
+    uint32_t pushed;        ///< written by producer only
+    uint32_t dropped;       ///< written by producer, or by any task if there are too many
+    uint32_t maxDepth;      ///< written by producer only
+    RadioEvent_t events[RADIO_QUEUE_SIZE];
+};
+
+static Ring rings[RADIO_QUEUES];
+
+/// ring of the task that pushed last, to skip the search in the common case
+static Ring* lastRing;
+
+
+/**
+ * @brief Find the ring owned by the current task, or claim a free one
+ */
+static Ring* myRing()
+{
+    TaskHandle_t me = xTaskGetCurrentTaskHandle();
+    Ring* r = __atomic_load_n( &lastRing, __ATOMIC_RELAXED );
+    if (r && r->owner == me) return r;
+    for (Ring& ring : rings) {
+        if (ring.owner == me) {
+            __atomic_store_n( &lastRing, &ring, __ATOMIC_RELAXED );
+            return &ring;
+        }
+    }
+    for (Ring& ring : rings) {
+        TaskHandle_t none = nullptr;
+        if (__atomic_compare_exchange_n( &ring.owner, &none, me, false, __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE ))
+            return &ring;
+    }
+    return nullptr;
+}
+
+
+/**
+ * @brief Add an event to the ring of the current task. O(1), never blocks.
+ *
+ * @return false if the event was dropped, because the ring was full, or
+ * more than RADIO_QUEUES tasks push events
+ */
+bool push( const RadioEvent_t& ev )
+{
+    Ring* r = myRing();
+    if (!r) {
+        // more producer tasks than rings, count the loss in the last ring
+        __atomic_fetch_add( &rings[RADIO_QUEUES-1].dropped, 1, __ATOMIC_RELAXED );
+        return false;
+    }
+    uint32_t h = r->head;
+    uint32_t depth = h - __atomic_load_n( &r->tail, __ATOMIC_ACQUIRE );
+    if (depth >= RADIO_QUEUE_SIZE) {
+        __atomic_fetch_add( &r->dropped, 1, __ATOMIC_RELAXED );
+        return false;
+    }
+    r->events[h & (RADIO_QUEUE_SIZE-1)] = ev;
+    __atomic_store_n( &r->head, h + 1, __ATOMIC_RELEASE );
+    __atomic_store_n( &r->pushed, r->pushed + 1, __ATOMIC_RELAXED );
+    if (depth + 1 > r->maxDepth) __atomic_store_n( &r->maxDepth, depth + 1, __ATOMIC_RELAXED );
+    return true;
+}
+
+
+/**
+ * @brief Take the oldest event from the first ring that has one.
+ * Must only be called by one task, the consumer.
+ *
+ * @return true if `ev` was filled in
+ */
+bool pop( RadioEvent_t& ev )
+{
+    for (Ring& r : rings) {
+        uint32_t t = r.tail;
+        if (t == __atomic_load_n( &r.head, __ATOMIC_ACQUIRE )) continue;
+        ev = r.events[t & (RADIO_QUEUE_SIZE-1)];
+        __atomic_store_n( &r.tail, t + 1, __ATOMIC_RELEASE );
+        return true;
+    }
+    return false;
+}
+
+
+/**
+ * @brief Get counters summed over all rings, max depth of all rings
+ */
+void queueStats( QueueStats_t& qs )
+{
+    qs = QueueStats_t{};
+    for (const Ring& r : rings) {
+        qs.pushed += __atomic_load_n( &r.pushed, __ATOMIC_RELAXED );
+        qs.dropped += __atomic_load_n( &r.dropped, __ATOMIC_RELAXED );
+        uint32_t d = __atomic_load_n( &r.maxDepth, __ATOMIC_RELAXED );
+        if (d > qs.maxDepth) qs.maxDepth = d;
+    }
+}
+
+} // namespace radio
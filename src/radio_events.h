@@ -0,0 +1,80 @@
+/**
+ * @file 		  radio_events.h
+ *
+ * Project		: Home automation
+ * Author		: Bernd Waldmann
+ * Created		: 16-Oct-2026
+ * Tabsize		: 4
+ *
+ * This Revision: $Id$
+ */
+
+/*
+   Copyright (C) 2024 Bernd Waldmann
+
+   This Source Code Form is subject to the terms of the Mozilla Public License, v. 2.0.
+   If a copy of the MPL was not distributed with this file, You can obtain one at http://mozilla.org/MPL/2.0/
+
+   SPDX-License-Identifier: MPL-2.0
+*/
+
+/**
+ * @brief Queue of radio events, from the MySensors hooks to loop().
+ *
+ * `previewMessage()` and `aftertransportSend()` run in the transport path, so
+ * they only capture a compact record of each message and push it into a ring
+ * buffer. All statistics are updated when loop() pops the records.
+ *
+ * Each task that pushes events (the MySensors process task, and the loop()
+ * task when it sends messages) gets its own single-producer/single-consumer
+ * ring of RADIO_QUEUE_SIZE records, so `push()` needs no lock: the producer
+ * only writes `head`, the consumer only writes `tail`. If a ring is full, the
+ * event is dropped and counted.
+ */
+
+#ifndef _radio_events_h
+#define _radio_events_h
+
+#include <Arduino.h>
+
+/// number of events per ring, must be a power of 2
+#ifndef RADIO_QUEUE_SIZE
+ #define RADIO_QUEUE_SIZE   64
+#endif
+
+/// max number of tasks that push events, each gets its own ring
+#ifndef RADIO_QUEUES
+ #define RADIO_QUEUES       2
+#endif
+
+namespace radio {
+
+enum EventKind : uint8_t { RECEIVED, SENT };
+
+/// one message seen by the hooks
+struct RadioEvent_t {
+    uint32_t t;             ///< [us] low 32 bits of esp_timer_get_time()
+    uint32_t hash;          ///< RECEIVED: hash for duplicate detection
+    EventKind kind;
+    uint8_t sender;         ///< original sender
+    uint8_t destination;    ///< final destination
+    uint8_t sensor, type, command;
+    uint8_t length;         ///< payload bytes
+    uint8_t hop;            ///< SENT: next hop
+    uint8_t arc;            ///< SENT: automatic retries required
+};
+
+/// counters for all rings
+struct QueueStats_t {
+    uint32_t pushed;        ///< events pushed since startup
+    uint32_t dropped;       ///< events dropped because a ring was full
+    uint32_t maxDepth;      ///< highest number of events waiting in one ring
+};
+
+bool push( const RadioEvent_t& ev );
+bool pop( RadioEvent_t& ev );
+void queueStats( QueueStats_t& qs );
+
+} // namespace radio
+
+#endif // _radio_events_h
@@ -0,0 +1,157 @@
+/**
+ * @file 		  scheduler.cpp
+ *
+ * Project		: Home automation
+ * Author		: Bernd Waldmann
+ * Created		: 16-Oct-2026
+ * Tabsize		: 4
+ *
+ * This Revision: $Id$
+ */
+
+/*
+   Copyright (C) 2024 Bernd Waldmann
+
+   This Source Code Form is subject to the terms of the Mozilla Public License, v. 2.0.
+   If a copy of the MPL was not distributed with this file, You can obtain one at http://mozilla.org/MPL/2.0/
+
+   SPDX-License-Identifier: MPL-2.0
+*/
+
+#include <esp_timer.h>
+#include "scheduler.h"
+
+namespace sched {
+
+struct Job_t {
+    const char* name;
+    JobFn fn;
+    unsigned long due;      ///< millis() when job should run next
+    bool triggered;         ///< run at next `run()`, regardless of `due`
+};
+
+static Job_t jobs[SCHED_MAX_JOBS];
+static unsigned nJobs;
+
+/// task that sleeps in `sleep()`, to be woken by `wake()`
+static TaskHandle_t sleeper;
+
+/// idle time, written by the sleeping task, read by the HTTP task
+static uint64_t idleUs;
+/// esp_timer_get_time() at start of the idle period, 0 until the first `run()`
+static int64_t t_periodStart;
+static portMUX_TYPE mux = portMUX_INITIALIZER_UNLOCKED;
+
+
+/**
+ * @brief Register a job. Call from setup().
+ *
+ * @param name          for log messages
+ * @param fn            the job, returns ms until it should run again
+ * @param firstDelay    ms from now until first run
+ * @return int  job id for `trigger()`, or -1 if there are too many jobs
+ */
+int add( const char* name, JobFn fn, uint32_t firstDelay )
+{
+    if (nJobs == SCHED_MAX_JOBS) {
+        log_e("too many jobs, '%s' not added, raise SCHED_MAX_JOBS (%d)", name, SCHED_MAX_JOBS);
+        return -1;
+    }
+    jobs[nJobs] = Job_t{ name, fn, millis() + firstDelay, false };
+    return nJobs++;
+}
+
+
+/**
+ * @brief Make a job run as soon as possible, and wake up loop()
+ */
+void trigger( int job )
+{
+    if (job < 0 || unsigned(job) >= nJobs) return;
+    jobs[job].triggered = true;
+    wake();
+}
+
+
+/**
+ * @brief Run all jobs that are due
+ *
+ * @return uint32_t ms until the next job is due
+ */
+uint32_t run( unsigned long t_now )
+{
+    if (t_periodStart == 0) {
+        // first call from loop(), time spent in setup() does not count
+        portENTER_CRITICAL( &mux );
+        t_periodStart = esp_timer_get_time();
+        portEXIT_CRITICAL( &mux );
+    }
+    uint32_t next = UINT32_MAX;
+    for (unsigned i=0; i<nJobs; i++) {
+        Job_t& job = jobs[i];
+        if (job.triggered || long(t_now - job.due) >= 0) {
+            job.triggered = false;
+            uint32_t delay = job.fn( t_now );
+            job.due = t_now + delay;
+        }
+        uint32_t wait = (long(job.due - t_now) > 0) ? job.due - t_now : 0;
+        if (wait < next) next = wait;
+    }
+    return next;
+}
+
+
+/**
+ * @brief Block the calling task for `ms`, or until `wake()` is called
+ */
+void sleep( uint32_t ms )
+{
+    if (ms == 0) return;
+    sleeper = xTaskGetCurrentTaskHandle();
+    int64_t t0 = esp_timer_get_time();
+    ulTaskNotifyTake( pdTRUE, pdMS_TO_TICKS(ms) );
+    int64_t t1 = esp_timer_get_time();
+    portENTER_CRITICAL( &mux );
+    idleUs += t1 - t0;
+    portEXIT_CRITICAL( &mux );
+}
+
+
+/**
+ * @brief End `sleep()` early. May be called from any task.
+ */
+void wake()
+{
+    TaskHandle_t t = sleeper;
+    if (t) xTaskNotifyGive( t );
+}
+
+
+/**
+ * @brief Get time spent in `sleep()` since last call, and start a new period
+ */
+void takeIdle( IdleStats_t& idle )
+{
+    int64_t now = esp_timer_get_time();
+    portENTER_CRITICAL( &mux );
+    idle.idleUs = idleUs;
+    idle.totalUs = t_periodStart ? now - t_periodStart : 0;
+    idleUs = 0;
+    t_periodStart = now;
+    portEXIT_CRITICAL( &mux );
+}
+
+
+/**
+ * @brief Get share of time spent in `sleep()` since last `takeIdle()`, in 0.1%
+ */
+unsigned idlePermille()
+{
+    int64_t now = esp_timer_get_time();
+    portENTER_CRITICAL( &mux );
+    uint64_t idle = idleUs, total = t_periodStart ? now - t_periodStart : 0;
+    portEXIT_CRITICAL( &mux );
+    return total ? unsigned(idle * 1000 / total) : 0;
+}
+
+} // namespace sched
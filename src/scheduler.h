@@ -0,0 +1,67 @@
+/**
+ * @file 		  scheduler.h
+ *
+ * Project		: Home automation
+ * Author		: Bernd Waldmann
+ * Created		: 16-Oct-2026
+ * Tabsize		: 4
+ *
+ * This Revision: $Id$
+ */
+
+/*
+   Copyright (C) 2024 Bernd Waldmann
+
+   This Source Code Form is subject to the terms of the Mozilla Public License, v. 2.0.
+   If a copy of the MPL was not distributed with this file, You can obtain one at http://mozilla.org/MPL/2.0/
+
+   SPDX-License-Identifier: MPL-2.0
+*/
+
+/**
+ * @brief Deadline scheduler for periodic jobs in loop().
+ *
+ * A job is a function that returns the time until it wants to run again, so
+ * it can have a fixed period or a pattern (like the LED blinker). `run()` calls
+ * all jobs that are due and returns the time until the next deadline, which
+ * loop() can spend in `sleep()`. Another task can cut the sleep short with
+ * `wake()`, e.g. when a message has arrived.
+ *
+ * Jobs run in the task that calls `run()`, so they may call MySensors `send()`.
+ * The time spent in `sleep()` is counted, to report how idle loop() is.
+ */
+
+#ifndef _scheduler_h
+#define _scheduler_h
+
+#include <Arduino.h>
+
+/// max number of jobs
+#ifndef SCHED_MAX_JOBS
+ #define SCHED_MAX_JOBS     12
+#endif
+
+namespace sched {
+
+/// a job gets the current millis(), and returns ms until it should run again
+typedef uint32_t (*JobFn)( unsigned long t_now );
+
+int add( const char* name, JobFn fn, uint32_t firstDelay );
+void trigger( int job );
+uint32_t run( unsigned long t_now );
+
+void sleep( uint32_t ms );
+void wake();
+
+/// time spent sleeping, since last `takeIdle()`
+struct IdleStats_t {
+    uint64_t idleUs;    ///< time spent in `sleep()`
+    uint64_t totalUs;   ///< time elapsed
+};
+
+void takeIdle( IdleStats_t& idle );
+unsigned idlePermille();
+
+} // namespace sched
+
+#endif // _scheduler_h
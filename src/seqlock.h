@@ -0,0 +1,61 @@
+/**
+ * @file 		  seqlock.h
+ *
+ * Project		: Home automation
+ * Author		: Bernd Waldmann
+ * Created		: 16-Oct-2026
+ * Tabsize		: 4
+ *
+ * This Revision: $Id$
+ */
+
+/*
+   Copyright (C) 2024 Bernd Waldmann
+
+   This Source Code Form is subject to the terms of the Mozilla Public License, v. 2.0.
+   If a copy of the MPL was not distributed with this file, You can obtain one at http://mozilla.org/MPL/2.0/
+
+   SPDX-License-Identifier: MPL-2.0
+*/
+
+/**
+ * @brief Sequence lock primitives, for data with a single writer and any
+ * number of readers. The writer never blocks; readers copy the data and
+ * retry if the sequence number was odd or has changed meanwhile.
+ *
+ *      beginWrite( seq ); ...write...; endWrite( seq );
+ *
+ *      do { s = beginRead( seq ); ...copy...; } while (!endRead( seq, s ));
+ */
+
+#ifndef _seqlock_h
+#define _seqlock_h
+
+#include <Arduino.h>
+
+static inline void beginWrite( volatile uint32_t& seq )
+{
+    __atomic_store_n( &seq, seq + 1, __ATOMIC_RELAXED );
+    __atomic_thread_fence( __ATOMIC_RELEASE );
+}
+
+static inline void endWrite( volatile uint32_t& seq )
+{
+    __atomic_store_n( &seq, seq + 1, __ATOMIC_RELEASE );
+}
+
+static inline uint32_t beginRead( volatile uint32_t& seq )
+{
+    uint32_t s;
+    // writer may have been preempted by us, so let it finish
+    while ((s = __atomic_load_n( &seq, __ATOMIC_ACQUIRE )) & 1) vTaskDelay(1);
+    return s;
+}
+
+static inline bool endRead( volatile uint32_t& seq, uint32_t s )
+{
+    __atomic_thread_fence( __ATOMIC_ACQUIRE );
+    return __atomic_load_n( &seq, __ATOMIC_RELAXED ) == s;
+}
+
+#endif // _seqlock_h
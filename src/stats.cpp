@@ -0,0 +1,589 @@
+/**
+ * @file 		  stats.cpp
+ *
+ * Project		: Home automation
+ * Author		: Bernd Waldmann
+ * Created		: 16-Oct-2026
+ * Tabsize		: 4
+ *
+ * This Revision: $Id$
+ */
+
+/*
+   Copyright (C) 2024 Bernd Waldmann
+
+   This Source Code Form is subject to the terms of the Mozilla Public License, v. 2.0.
+   If a copy of the MPL was not distributed with this file, You can obtain one at http://mozilla.org/MPL/2.0/
+
+   SPDX-License-Identifier: MPL-2.0
+*/
+
+#include <stddef.h>
+#include <esp_timer.h>
+#include "stats.h"
+#include "seqlock.h"
+
+namespace stats {
+
+static_assert( sizeof(StatsCounters_t) % sizeof(unsigned) == 0, "StatsCounters_t must only contain unsigned" );
+/// number of counters before `nodes`, these are always summed up
+const size_t NUM_GLOBAL_COUNTERS = offsetof(StatsCounters_t, nodes) / sizeof(unsigned);
+
+/// counters written by one task only, guarded by a sequence lock
+struct Shard {
+    volatile uint32_t seq;          ///< odd while the owner is writing
+    TaskHandle_t owner;             ///< task that writes this shard
+    StatsCounters_t c;
+};
+
+static Shard shards[STATS_SHARDS];
+
+/// totals at time of last clear, guarded by a sequence lock
+static volatile uint32_t baseSeq;
+static StatsCounters_t baseline;
+static time_t t_last_clear;
+
+/// serializes writers of the baseline, i.e. clear() and restore()
+static StaticSemaphore_t clearMutexBuffer;
+static SemaphoreHandle_t clearMutex = xSemaphoreCreateMutexStatic( &clearMutexBuffer );
+
+/// bit i is set when node id i has been seen since startup, bits are never cleared
+static uint32_t activeBits[256/32];
+
+/// bit i is set when counters for node id i have changed since last `takeDirty()`
+static uint32_t dirtyNodes[256/32];
+
+/// duration of one bucket for each window, in seconds
+static const uint32_t bucketWidth[NUM_WINDOWS] = { 
+    60 / STATS_WINDOW_BUCKETS, 
+    3600 / STATS_WINDOW_BUCKETS, 
+    86400 / STATS_WINDOW_BUCKETS 
+};
+static_assert( 60 % STATS_WINDOW_BUCKETS == 0, "STATS_WINDOW_BUCKETS must divide 60" );
+
+struct WindowBucket_t {
+    uint16_t rx, tx, retries;
+};
+
+/// everything about one node that is not sharded
+struct NodeRecord_t {
+    uint32_t lastSeen;  ///< `windowTime()` of last message from or to node, 0 if never
+    WindowBucket_t buckets[NUM_WINDOWS][STATS_WINDOW_BUCKETS];
+    uint8_t arcHistogram[16];   ///< arcHistogram[i] counts packets that required i retries
+};
+
+static NodeRecord_t nodeRecords[256];
+static_assert( sizeof(NodeRecord_t) == 4 + NUM_WINDOWS * STATS_WINDOW_BUCKETS * 6 + 16, "RAM figure in stats.h is wrong" );
+
+/// guards node records, which are written by all tasks that count events
+static portMUX_TYPE nodesMux = portMUX_INITIALIZER_UNLOCKED;
+
+/**
+ * @brief Find the shard owned by the current task, or claim a free one
+ */
+static Shard& myShard()
+{
+    TaskHandle_t me = xTaskGetCurrentTaskHandle();
+    for (Shard& s : shards) 
+        if (s.owner == me) return s;
+    for (Shard& s : shards) {
+        TaskHandle_t none = nullptr;
+        if (__atomic_compare_exchange_n( &s.owner, &none, me, false, __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE ))
+            return s;
+    }
+    // more writer tasks than shards: share the last one, increments may get lost
+    static bool warned = false;
+    if (!warned) {
+        log_e("more than %d tasks count statistics", STATS_SHARDS);
+        warned = true;
+    }
+    return shards[STATS_SHARDS-1];
+}
+
+
+static inline void markDirty( uint8_t id )
+{
+    __atomic_fetch_or( &dirtyNodes[id >> 5], 1uL << (id & 31), __ATOMIC_RELAXED );
+}
+
+
+/// set bit for a node in the active bitmap. Call before writing counters,
+/// so readers that see the counters also see the bit.
+static inline void markActive( uint8_t id )
+{
+    uint32_t bit = 1uL << (id & 31);
+    if (!(__atomic_load_n( &activeBits[id >> 5], __ATOMIC_RELAXED ) & bit))
+        __atomic_fetch_or( &activeBits[id >> 5], bit, __ATOMIC_RELEASE );
+}
+
+
+/// dst += src, for global counters and all active nodes
+static void addCounters( StatsCounters_t& dst, const StatsCounters_t& src, const uint32_t (&active)[256/32] )
+{
+    unsigned* d = (unsigned*)&dst;
+    const unsigned* s = (const unsigned*)&src;
+    for (size_t i=0; i<NUM_GLOBAL_COUNTERS; i++) d[i] += s[i];
+    forEachNode( active, [&](unsigned id) {
+        dst.nodes[id].rx += src.nodes[id].rx;
+        dst.nodes[id].tx += src.nodes[id].tx;
+        dst.nodes[id].retries += src.nodes[id].retries;
+        dst.nodes[id].dups += src.nodes[id].dups;
+    });
+}
+
+
+/// dst += src, for all counters, including nodes that may become active meanwhile
+static void addAllCounters( StatsCounters_t& dst, const StatsCounters_t& src )
+{
+    unsigned* d = (unsigned*)&dst;
+    const unsigned* s = (const unsigned*)&src;
+    for (size_t i=0; i < sizeof(StatsCounters_t) / sizeof(unsigned); i++) d[i] += s[i];
+}
+
+
+/// dst -= src, for global counters and all active nodes
+static void subCounters( StatsCounters_t& dst, const StatsCounters_t& src, const uint32_t (&active)[256/32] )
+{
+    unsigned* d = (unsigned*)&dst;
+    const unsigned* s = (const unsigned*)&src;
+    for (size_t i=0; i<NUM_GLOBAL_COUNTERS; i++) d[i] -= s[i];
+    forEachNode( active, [&](unsigned id) {
+        dst.nodes[id].rx -= src.nodes[id].rx;
+        dst.nodes[id].tx -= src.nodes[id].tx;
+        dst.nodes[id].retries -= src.nodes[id].retries;
+        dst.nodes[id].dups -= src.nodes[id].dups;
+    });
+}
+
+
+/// true if no node has become active since `active` was read
+static bool sameActive( const uint32_t (&active)[256/32] )
+{
+    for (unsigned w=0; w < 256/32; w++)
+        if (__atomic_load_n( &activeBits[w], __ATOMIC_ACQUIRE ) != active[w]) return false;
+    return true;
+}
+
+
+/**
+ * @brief Read counters consistently: call `add()` for each shard, and 
+ * `sub()` for the baseline. Starts over with `reset()` if any writer 
+ * interfered.
+ */
+template<typename Reset, typename Add, typename Sub>
+static void readConsistent( Reset reset, Add add, Sub sub )
+{
+    for (;;) {
+        reset();
+        uint32_t b = beginRead( baseSeq );
+        bool ok = true;
+        for (Shard& s : shards) {
+            uint32_t q = beginRead( s.seq );
+            add( s.c );
+            if (!endRead( s.seq, q )) { ok = false; break; }
+        }
+        if (!ok) continue;
+        sub( baseline );
+        if (endRead( baseSeq, b )) return;
+    }
+}
+
+//----- rolling windows
+
+/**
+ * @brief Seconds since startup, plus 1 so that 0 can mean "never"
+ */
+static inline uint32_t windowTime()
+{
+    return uint32_t(esp_timer_get_time() / 1000000) + 1;
+}
+
+
+static inline void addSaturated( uint16_t& counter, unsigned n )
+{
+    counter = (counter + n > UINT16_MAX) ? UINT16_MAX : counter + n;
+}
+
+
+/**
+ * @brief Clear buckets that have expired since last rotation. 
+ * At most STATS_WINDOW_BUCKETS buckets per window are touched.
+ */
+static void rotateWindows( NodeRecord_t& nr, uint32_t now )
+{
+    if (nr.lastSeen == now) return;
+    for (unsigned w=0; w<NUM_WINDOWS; w++) {
+        uint32_t last = nr.lastSeen / bucketWidth[w], cur = now / bucketWidth[w];
+        if (nr.lastSeen == 0 || cur - last >= STATS_WINDOW_BUCKETS) {
+            memset( nr.buckets[w], 0, sizeof nr.buckets[w] );
+        } else {
+            for (uint32_t k=last+1; k<=cur; k++) 
+                nr.buckets[w][k % STATS_WINDOW_BUCKETS] = WindowBucket_t{};
+        }
+    }
+    nr.lastSeen = now;
+}
+
+
+/**
+ * @brief Count traffic in rolling windows, call with `nodesMux` held
+ */
+static void countWindows( uint8_t id, uint32_t now, unsigned rx, unsigned tx, unsigned retries )
+{
+    NodeRecord_t& nr = nodeRecords[id];
+    rotateWindows( nr, now );
+    for (unsigned w=0; w<NUM_WINDOWS; w++) {
+        WindowBucket_t& b = nr.buckets[w][(now / bucketWidth[w]) % STATS_WINDOW_BUCKETS];
+        addSaturated( b.rx, rx );
+        addSaturated( b.tx, tx );
+        addSaturated( b.retries, retries );
+    }
+}
+
+
+/**
+ * @brief Count retries in per-node histogram, call with `nodesMux` held
+ */
+static void countArcHistogram( uint8_t id, unsigned bin )
+{
+    uint8_t (&hist)[16] = nodeRecords[id].arcHistogram;
+    if (hist[bin] == UINT8_MAX) 
+        for (uint8_t& h : hist) h >>= 1;
+    hist[bin]++;
+}
+
+//----- writers
+
+void countRxTx( RxTxEvent ev )
+{
+    Shard& s = myShard();
+    beginWrite( s.seq );
+    switch (ev) {
+        case RX:        s.c.rxtxStats.nRx++; break;
+        case TX:        s.c.rxtxStats.nTx++; break;
+        case GW_RX:     s.c.rxtxStats.nGwRx++; break;
+        case GW_TX:     s.c.rxtxStats.nGwTx++; break;
+        case ERR_TX:    s.c.rxtxStats.nErr++; break;
+    }
+    endWrite( s.seq );
+}
+
+
+void countReceived( uint8_t sender )
+{
+    markActive( sender );
+    Shard& s = myShard();
+    beginWrite( s.seq );
+    s.c.nodes[sender].rx++;
+    endWrite( s.seq );
+    markDirty( sender );
+    uint32_t now = windowTime();
+    portENTER_CRITICAL( &nodesMux );
+    countWindows( sender, now, 1, 0, 0 );
+    portEXIT_CRITICAL( &nodesMux );
+}
+
+
+/**
+ * @brief Count a message that was received again, e.g. because the ACK was lost.
+ * It does not count as received, and is not included in rolling windows.
+ */
+void countDuplicate( uint8_t sender )
+{
+    markActive( sender );
+    Shard& s = myShard();
+    beginWrite( s.seq );
+    s.c.nodes[sender].dups++;
+    endWrite( s.seq );
+    markDirty( sender );
+}
+
+
+void countSent( uint8_t nextRecipient, unsigned arc )
+{
+    unsigned bin = (arc < STATS_ARC_LIMIT) ? arc : STATS_ARC_LIMIT;
+    markActive( nextRecipient );
+    Shard& s = myShard();
+    beginWrite( s.seq );
+    s.c.arcStats.packets++;
+    s.c.arcStats.retries += arc;
+    s.c.arcStats.histogram[bin]++;
+    s.c.nodes[nextRecipient].tx++;
+    s.c.nodes[nextRecipient].retries += arc;
+    endWrite( s.seq );
+    markDirty( nextRecipient );
+    uint32_t now = windowTime();
+    portENTER_CRITICAL( &nodesMux );
+    countWindows( nextRecipient, now, 0, 1, arc );
+    countArcHistogram( nextRecipient, bin );
+    portEXIT_CRITICAL( &nodesMux );
+}
+
+//----- readers
+
+/**
+ * @brief Clear statistics, by making current totals the new baseline.
+ * Writers are not affected. The baseline is summed up in place, readers
+ * wait until it is complete.
+ */
+void clear( time_t now )
+{
+    uint32_t active[256/32];
+    activeNodes( active );
+    xSemaphoreTake( clearMutex, portMAX_DELAY );
+    beginWrite( baseSeq );
+    for (;;) {
+        memset( &baseline, 0, sizeof baseline );
+        bool ok = true;
+        for (Shard& s : shards) {
+            uint32_t q = beginRead( s.seq );
+            addAllCounters( baseline, s.c );
+            if (!endRead( s.seq, q )) { ok = false; break; }
+        }
+        if (ok) break;
+    }
+    t_last_clear = now;
+    endWrite( baseSeq );
+    xSemaphoreGive( clearMutex );
+    forEachNode( active, [](unsigned id) {
+        portENTER_CRITICAL( &nodesMux );
+        memset( nodeRecords[id].arcHistogram, 0, sizeof nodeRecords[id].arcHistogram );
+        portEXIT_CRITICAL( &nodesMux );
+    });
+    markActiveDirty();
+}
+
+
+/**
+ * @brief Add counters saved before a reboot to the counters since last clear,
+ * by subtracting them from the baseline. Totals since startup are not affected,
+ * per-node histograms and rolling windows are not restored.
+ */
+void restore( const StatsCounters_t& sinceClear, time_t t )
+{
+    uint32_t restored[256/32] = {};
+    for (unsigned id=0; id<256; id++)
+        if (hasCounts( sinceClear.nodes[id] )) restored[id >> 5] |= 1uL << (id & 31);
+    forEachNode( restored, [](unsigned id) { markActive( id ); } );
+
+    xSemaphoreTake( clearMutex, portMAX_DELAY );
+    beginWrite( baseSeq );
+    subCounters( baseline, sinceClear, restored );
+    t_last_clear = t;
+    endWrite( baseSeq );
+    xSemaphoreGive( clearMutex );
+    markActiveDirty();
+}
+
+
+/**
+ * @brief Get all counters since last clear
+ */
+void snapshot( StatsSnapshot_t& snap )
+{
+    StatsCounters_t& c = snap;
+    do {
+        activeNodes( snap.active );
+        readConsistent(
+            [&]() { memset( &c, 0, sizeof c ); },
+            [&](const StatsCounters_t& s) { addCounters( c, s, snap.active ); },
+            [&](const StatsCounters_t& b) { 
+                subCounters( c, b, snap.active ); 
+                snap.t_last_clear = t_last_clear;
+            } );
+    } while (!sameActive( snap.active ));
+    snap.arcStats.success = arcSuccess( snap.arcStats.packets, snap.arcStats.retries );
+    snap.generation = generation();
+}
+
+
+/**
+ * @brief Get all counters since startup, these are never cleared. 
+ * `t_last_clear` is set to 0.
+ */
+void totals( StatsSnapshot_t& totals )
+{
+    StatsCounters_t& c = totals;
+    do {
+        activeNodes( totals.active );
+        for (;;) {
+            memset( &c, 0, sizeof c );
+            bool ok = true;
+            for (Shard& s : shards) {
+                uint32_t q = beginRead( s.seq );
+                addCounters( c, s.c, totals.active );
+                if (!endRead( s.seq, q )) { ok = false; break; }
+            }
+            if (ok) break;
+        }
+    } while (!sameActive( totals.active ));
+    totals.arcStats.success = arcSuccess( totals.arcStats.packets, totals.arcStats.retries );
+    totals.t_last_clear = 0;
+    totals.generation = generation();
+}
+
+
+/**
+ * @brief Get global counters since last clear, cheaper than `snapshot()`
+ */
+void globals( RxTxStats_t& rxtx, ArcStats_t& arc )
+{
+    readConsistent(
+        [&]() { rxtx = RxTxStats_t{}; arc = ArcStats_t{}; },
+        [&](const StatsCounters_t& c) { 
+            rxtx.nRx += c.rxtxStats.nRx; rxtx.nTx += c.rxtxStats.nTx; rxtx.nErr += c.rxtxStats.nErr;
+            rxtx.nGwRx += c.rxtxStats.nGwRx; rxtx.nGwTx += c.rxtxStats.nGwTx;
+            arc.packets += c.arcStats.packets; arc.retries += c.arcStats.retries;
+            for (unsigned i=0; i<16; i++) arc.histogram[i] += c.arcStats.histogram[i];
+        },
+        [&](const StatsCounters_t& c) { 
+            rxtx.nRx -= c.rxtxStats.nRx; rxtx.nTx -= c.rxtxStats.nTx; rxtx.nErr -= c.rxtxStats.nErr;
+            rxtx.nGwRx -= c.rxtxStats.nGwRx; rxtx.nGwTx -= c.rxtxStats.nGwTx;
+            arc.packets -= c.arcStats.packets; arc.retries -= c.arcStats.retries;
+            for (unsigned i=0; i<16; i++) arc.histogram[i] -= c.arcStats.histogram[i];
+        } );
+    arc.success = arcSuccess( arc.packets, arc.retries );
+}
+
+
+/**
+ * @brief Get counters for one node since last clear
+ */
+NodeCounters_t node( uint8_t id )
+{
+    NodeCounters_t n;
+    readConsistent(
+        [&]() { n = NodeCounters_t{}; },
+        [&](const StatsCounters_t& c) { 
+            n.rx += c.nodes[id].rx; n.tx += c.nodes[id].tx; n.retries += c.nodes[id].retries; 
+            n.dups += c.nodes[id].dups;
+        },
+        [&](const StatsCounters_t& c) { 
+            n.rx -= c.nodes[id].rx; n.tx -= c.nodes[id].tx; n.retries -= c.nodes[id].retries; 
+            n.dups -= c.nodes[id].dups;
+        } );
+    return n;
+}
+
+
+/**
+ * @brief Get traffic of one node in the last minute, hour and day. 
+ * Not affected by `clear()`.
+ */
+void windows( uint8_t id, WindowStats_t (&w)[NUM_WINDOWS] )
+{
+    for (unsigned i=0; i<NUM_WINDOWS; i++) w[i] = WindowStats_t{};
+    if (!isNodeSet( activeBits, id )) return;
+
+    uint32_t now = windowTime();
+    NodeRecord_t copy;
+    portENTER_CRITICAL( &nodesMux );
+    copy = nodeRecords[id];
+    portEXIT_CRITICAL( &nodesMux );
+    if (copy.lastSeen == 0) return;
+    rotateWindows( copy, now );
+
+    for (unsigned i=0; i<NUM_WINDOWS; i++) {
+        for (const WindowBucket_t& b : copy.buckets[i]) {
+            w[i].rx += b.rx;
+            w[i].tx += b.tx;
+            w[i].retries += b.retries;
+        }
+    }
+}
+
+
+/**
+ * @brief Get distribution of retries for messages sent to one node since last clear
+ */
+ArcPercentiles_t nodeArcPercentiles( uint8_t id )
+{
+    uint8_t hist[16];
+    portENTER_CRITICAL( &nodesMux );
+    memcpy( hist, nodeRecords[id].arcHistogram, sizeof hist );
+    portEXIT_CRITICAL( &nodesMux );
+    return arcPercentiles( hist );
+}
+
+
+/**
+ * @brief Get the time currently covered by a rolling window, in seconds: 
+ * all full buckets plus the current partial one, but not more than the uptime.
+ */
+unsigned windowSpan( Window w )
+{
+    uint32_t now = windowTime();
+    uint32_t span = (STATS_WINDOW_BUCKETS-1) * bucketWidth[w] + (now % bucketWidth[w]) + 1;
+    return (span < now) ? span : now;
+}
+
+
+/**
+ * @brief Get a number that changes whenever any counter changes, or the 
+ * statistics are cleared. Each write or clear advances a sequence number by 2.
+ */
+uint32_t generation()
+{
+    uint32_t gen = baseSeq;
+    for (Shard& s : shards) gen += s.seq;
+    return gen / 2;
+}
+
+
+/**
+ * @brief Get time of last clear
+ */
+time_t lastClear()
+{
+    time_t t;
+    uint32_t b;
+    do {
+        b = beginRead( baseSeq );
+        t = t_last_clear;
+    } while (!endRead( baseSeq, b ));
+    return t;
+}
+
+
+/**
+ * @brief Get and reset the set of nodes whose counters have changed
+ */
+void takeDirty( uint32_t (&dirty)[256/32] )
+{
+    for (unsigned w=0; w < 256/32; w++)
+        dirty[w] = __atomic_exchange_n( &dirtyNodes[w], 0, __ATOMIC_ACQ_REL );
+}
+
+
+/**
+ * @brief Mark all active nodes as changed
+ */
+void markActiveDirty()
+{
+    for (unsigned w=0; w < 256/32; w++)
+        __atomic_fetch_or( &dirtyNodes[w], __atomic_load_n( &activeBits[w], __ATOMIC_ACQUIRE ), __ATOMIC_RELAXED );
+}
+
+
+/**
+ * @brief Get the set of nodes seen since startup
+ */
+void activeNodes( uint32_t (&active)[256/32] )
+{
+    for (unsigned w=0; w < 256/32; w++)
+        active[w] = __atomic_load_n( &activeBits[w], __ATOMIC_ACQUIRE );
+}
+
+
+/**
+ * @brief Get time since last message from or to a node, UINT32_MAX if never seen
+ */
+uint32_t secondsSinceSeen( uint8_t id )
+{
+    portENTER_CRITICAL( &nodesMux );
+    uint32_t lastSeen = nodeRecords[id].lastSeen;
+    portEXIT_CRITICAL( &nodesMux );
+    return lastSeen ? windowTime() - lastSeen : UINT32_MAX;
+}
+
+} // namespace stats
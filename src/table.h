@@ -0,0 +1,42 @@
+/**
+ * @file 		  table.h
+ *
+ * Project		: Home automation
+ * Author		: Bernd Waldmann
+ * Created		: 16-Oct-2026
+ * Tabsize		: 4
+ *
+ * This Revision: $Id$
+ */
+
+/*
+   Copyright (C) 2024 Bernd Waldmann
+
+   This Source Code Form is subject to the terms of the Mozilla Public License, v. 2.0.
+   If a copy of the MPL was not distributed with this file, You can obtain one at http://mozilla.org/MPL/2.0/
+
+   SPDX-License-Identifier: MPL-2.0
+*/
+
+/**
+ * @brief Server-rendered HTML table of per-node statistics, for the %TABLE%
+ * keyword of the web page: one row per group of 10 node ids that contains
+ * an active node, with messages received, rate, TX success and ARC percentiles.
+ *
+ * Rendering writes directly to a TextWriter and makes no heap allocations.
+ */
+
+#ifndef _table_h
+#define _table_h
+
+#include <Arduino.h>
+#include "text_writer.h"
+#include "stats.h"
+
+namespace table {
+
+void render( TextWriter& out, const StatsSnapshot_t& snap, time_t nSecsElapsed );
+
+} // namespace table
+
+#endif // _table_h
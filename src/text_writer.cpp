@@ -0,0 +1,77 @@
+/**
+ * @file 		  text_writer.cpp
+ *
+ * Project		: Home automation
+ * Author		: Bernd Waldmann
+ * Created		: 16-Oct-2026
+ * Tabsize		: 4
+ *
+ * This Revision: $Id$
+ */
+
+/*
+   Copyright (C) 2024 Bernd Waldmann
+
+   This Source Code Form is subject to the terms of the Mozilla Public License, v. 2.0.
+   If a copy of the MPL was not distributed with this file, You can obtain one at http://mozilla.org/MPL/2.0/
+
+   SPDX-License-Identifier: MPL-2.0
+*/
+
+#include "text_writer.h"
+
+
+TextWriter::TextWriter( char* buf, size_t size, FlushFn flushFn, void* ctx )
+    : _buf(buf), _size(size), _len(0), _total(0), 
+      _flushFn(flushFn), _ctx(ctx), _overflow(false)
+{
+    if (_size) _buf[0] = '\0';
+}
+
+
+/**
+ * @brief Append `len` characters to the buffer, flush or truncate if it is full
+ */
+void TextWriter::write( const char* s, size_t len )
+{
+    if (_size == 0) { _overflow = (len > 0); return; }
+    while (len) {
+        size_t room = _size - 1 - _len;
+        if (room == 0) {
+            if (!_flushFn) { 
+                _overflow = true; 
+                break; 
+            }
+            flush();
+            continue;
+        }
+        size_t n = (len < room) ? len : room;
+        memcpy( _buf + _len, s, n );
+        _len += n;
+        _total += n;
+        s += n;
+        len -= n;
+    }
+    _buf[_len] = '\0';
+}
+
+
+/**
+ * @brief Append decimal representation of an unsigned integer
+ */
+void TextWriter::print( unsigned u )
+{
+    char digits[11];
+    utoa( u, digits, 10 );
+    print( digits );
+}
+
+
+void TextWriter::flush()
+{
+    if (_flushFn && _len) {
+        _flushFn( _ctx, _buf, _len );
+        _len = 0;
+        _buf[0] = '\0';
+    }
+}
@@ -0,0 +1,68 @@
+/**
+ * @file 		  text_writer.h
+ *
+ * Project		: Home automation
+ * Author		: Bernd Waldmann
+ * Created		: 16-Oct-2026
+ * Tabsize		: 4
+ *
+ * This Revision: $Id$
+ */
+
+/*
+   Copyright (C) 2024 Bernd Waldmann
+
+   This Source Code Form is subject to the terms of the Mozilla Public License, v. 2.0.
+   If a copy of the MPL was not distributed with this file, You can obtain one at http://mozilla.org/MPL/2.0/
+
+   SPDX-License-Identifier: MPL-2.0
+*/
+
+/**
+ * @brief Append-only text writer over a fixed, caller-supplied buffer.
+ *
+ * If a flush function is given, the buffer is handed to it whenever it is full,
+ * so arbitrarily long output can be streamed with a small buffer. Without a 
+ * flush function, output beyond the buffer size is dropped, and `overflowed()`
+ * returns true. The buffer content is always 0-terminated.
+ */
+
+#ifndef _text_writer_h
+#define _text_writer_h
+
+#include <Arduino.h>
+
+class TextWriter {
+public:
+    /// called with the buffered text, when buffer is full or on `flush()`
+    typedef void (*FlushFn)( void* ctx, const char* data, size_t len );
+
+    TextWriter( char* buf, size_t size, FlushFn flushFn=nullptr, void* ctx=nullptr );
+
+    void write( const char* s, size_t len );
+    void print( const char* s ) { if (s) write(s, strlen(s)); }
+    void print( const String& s ) { write(s.c_str(), s.length()); }
+    void print( unsigned u );
+
+    /// hand buffered text to the flush function, if any
+    void flush();
+
+    const char* c_str() const { return _buf; }
+    /// # of characters currently in the buffer
+    size_t length() const { return _len; }
+    /// # of characters written since construction, including those flushed
+    size_t total() const { return _total; }
+    /// true if some output was dropped because the buffer was full
+    bool overflowed() const { return _overflow; }
+
+private:
+    char* _buf;
+    size_t _size;
+    size_t _len;
+    size_t _total;
+    FlushFn _flushFn;
+    void* _ctx;
+    bool _overflow;
+};
+
+#endif // _text_writer_h
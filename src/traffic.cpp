@@ -0,0 +1,245 @@
+/**
+ * @file 		  traffic.cpp
+ *
+ * Project		: Home automation
+ * Author		: Bernd Waldmann
+ * Created		: 16-Oct-2026
+ * Tabsize		: 4
+ *
+ * This Revision: $Id$
+ */
+
+/*
+   Copyright (C) 2024 Bernd Waldmann
+
+   This Source Code Form is subject to the terms of the Mozilla Public License, v. 2.0.
+   If a copy of the MPL was not distributed with this file, You can obtain one at http://mozilla.org/MPL/2.0/
+
+   SPDX-License-Identifier: MPL-2.0
+*/
+
+#include "traffic.h"
+
+static_assert( (TRAFFIC_SLOTS & (TRAFFIC_SLOTS-1)) == 0, "TRAFFIC_SLOTS must be a power of 2" );
+static_assert( TRAFFIC_PROBES <= TRAFFIC_SLOTS, "too many probes" );
+static_assert( TRAFFIC_TOP < 255, "too many top entries" );
+
+namespace traffic {
+
+const uint8_t NOT_TOP = 0xFF;
+
+/// one entry of the hash table, free if count is 0
+struct Slot_t {
+    uint32_t key;       ///< node/sensor/command/type
+    uint32_t count;
+    uint32_t bytes;
+    uint32_t error;
+    uint8_t rank;       ///< position in `topSlots`, or NOT_TOP
+};
+
+static Slot_t slots[TRAFFIC_SLOTS];
+/// indexes into `slots`, sorted by descending count
+static uint16_t topSlots[TRAFFIC_TOP];
+static unsigned nTop;
+static unsigned nUsed;
+static uint32_t nEvictions;
+static CommandTotals_t commandTotals;
+
+/// written by loop(), read by the HTTP task
+static portMUX_TYPE mux = portMUX_INITIALIZER_UNLOCKED;
+
+
+static inline uint32_t makeKey( uint8_t node, uint8_t sensor, uint8_t command, uint8_t type )
+{
+    return (uint32_t(node) << 24) | (uint32_t(sensor) << 16) | (uint32_t(command) << 8) | type;
+}
+
+
+static inline unsigned hash( uint32_t key )
+{
+    return (key * 2654435761uL) >> 16 & (TRAFFIC_SLOTS-1);
+}
+
+
+static void toEntry( const Slot_t& s, TrafficEntry_t& e )
+{
+    e.node = s.key >> 24;
+    e.sensor = s.key >> 16;
+    e.command = s.key >> 8;
+    e.type = s.key;
+    e.count = s.count;
+    e.bytes = s.bytes;
+    e.error = s.error;
+}
+
+
+/**
+ * @brief Move slot `i` up the top list after its count was incremented
+ */
+static void promote( unsigned i )
+{
+    Slot_t& s = slots[i];
+    unsigned r = s.rank;
+    if (r == NOT_TOP) {
+        if (nTop < TRAFFIC_TOP) {
+            r = nTop++;
+        } else {
+            r = nTop-1;
+            if (slots[topSlots[r]].count >= s.count) return;
+            slots[topSlots[r]].rank = NOT_TOP;
+        }
+        topSlots[r] = i;
+    }
+    while (r > 0 && slots[topSlots[r-1]].count < s.count) {
+        topSlots[r] = topSlots[r-1];
+        slots[topSlots[r]].rank = r;
+        r--;
+    }
+    topSlots[r] = i;
+    s.rank = r;
+}
+
+
+/**
+ * @brief Count a received message.
+ */
+void count( uint8_t node, uint8_t sensor, uint8_t command, uint8_t type, uint8_t length )
+{
+    uint32_t key = makeKey( node, sensor, command, type );
+    unsigned h = hash( key );
+    portENTER_CRITICAL( &mux );
+    commandTotals.count[command % NUM_COMMANDS]++;
+    commandTotals.bytes[command % NUM_COMMANDS] += length;
+    unsigned victim = h;
+    unsigned i = h;
+    for (unsigned p=0; p < TRAFFIC_PROBES; p++, i = (i+1) & (TRAFFIC_SLOTS-1)) {
+        Slot_t& s = slots[i];
+        if (s.count == 0) {
+            // entries are never removed singly, so the key is not further down
+            s.key = key;
+            s.error = 0;
+            s.bytes = 0;
+            s.rank = NOT_TOP;
+            nUsed++;
+            victim = i;
+            break;
+        }
+        if (s.key == key) {
+            victim = i;
+            break;
+        }
+        if (s.count < slots[victim].count) victim = i;
+        if (p == TRAFFIC_PROBES-1) {
+            // no match and no free slot: replace entry with lowest count
+            Slot_t& v = slots[victim];
+            v.key = key;
+            v.error = v.count;
+            v.bytes = 0;
+            nEvictions++;
+        }
+    }
+    Slot_t& s = slots[victim];
+    s.count++;
+    s.bytes += length;
+    promote( victim );
+    portEXIT_CRITICAL( &mux );
+}
+
+
+/**
+ * @brief Remove all entries
+ */
+void clear()
+{
+    portENTER_CRITICAL( &mux );
+    memset( slots, 0, sizeof slots );
+    memset( &commandTotals, 0, sizeof commandTotals );
+    nTop = 0;
+    nUsed = 0;
+    nEvictions = 0;
+    portEXIT_CRITICAL( &mux );
+}
+
+
+/**
+ * @brief Get entries with the highest message counts, in descending order
+ *
+ * @param entries   array to be filled
+ * @param max       size of array
+ * @return unsigned number of entries filled in, at most TRAFFIC_TOP
+ */
+unsigned top( TrafficEntry_t* entries, unsigned max )
+{
+    portENTER_CRITICAL( &mux );
+    unsigned n = (max < nTop) ? max : nTop;
+    for (unsigned r=0; r<n; r++)
+        toEntry( slots[topSlots[r]], entries[r] );
+    portEXIT_CRITICAL( &mux );
+    return n;
+}
+
+
+/**
+ * @brief Get all entries for messages from one node, in table order.
+ * This scans the whole table.
+ *
+ * @param id        node id
+ * @param entries   array to be filled
+ * @param max       size of array
+ * @return unsigned number of entries filled in
+ */
+unsigned node( uint8_t id, TrafficEntry_t* entries, unsigned max )
+{
+    unsigned n = 0;
+    portENTER_CRITICAL( &mux );
+    for (const Slot_t& s : slots) {
+        if (n == max) break;
+        if (s.count && (s.key >> 24) == id)
+            toEntry( s, entries[n++] );
+    }
+    portEXIT_CRITICAL( &mux );
+    return n;
+}
+
+
+/**
+ * @brief Get message and byte counts per command, including evicted entries
+ */
+void commands( CommandTotals_t& totals )
+{
+    portENTER_CRITICAL( &mux );
+    totals = commandTotals;
+    portEXIT_CRITICAL( &mux );
+}
+
+
+/**
+ * @brief Get number of slots in use
+ */
+unsigned used()
+{
+    return nUsed;
+}
+
+
+/**
+ * @brief Get number of entries that were replaced because the table was full
+ */
+uint32_t evictions()
+{
+    return nEvictions;
+}
+
+
+/**
+ * @brief Get name of MySensors command, as used in JSON output
+ */
+const char* commandName( uint8_t command )
+{
+    static const char* const names[NUM_COMMANDS] = {
+        "presentation", "set", "req", "internal", "stream", "5", "6", "7"
+    };
+    return names[command % NUM_COMMANDS];
+}
+
+} // namespace traffic
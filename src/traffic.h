@@ -0,0 +1,89 @@
+/**
+ * @file 		  traffic.h
+ *
+ * Project		: Home automation
+ * Author		: Bernd Waldmann
+ * Created		: 16-Oct-2026
+ * Tabsize		: 4
+ *
+ * This Revision: $Id$
+ */
+
+/*
+   Copyright (C) 2024 Bernd Waldmann
+
+   This Source Code Form is subject to the terms of the Mozilla Public License, v. 2.0.
+   If a copy of the MPL was not distributed with this file, You can obtain one at http://mozilla.org/MPL/2.0/
+
+   SPDX-License-Identifier: MPL-2.0
+*/
+
+/**
+ * @brief Traffic matrix: received messages and payload bytes per
+ * node/sensor/command/type, to find chatty sensors.
+ *
+ * Counters live in a fixed hash table with open addressing (TRAFFIC_SLOTS
+ * entries, linear probing over at most TRAFFIC_PROBES slots). If no slot is
+ * free, the entry with the lowest count within the probe window is replaced,
+ * as in the "Space-Saving" algorithm: the new entry starts with the count of
+ * the evicted one plus 1, and remembers that count as its possible error.
+ * So heavy hitters are never lost, only rare messages are lumped together.
+ *
+ * The TRAFFIC_TOP entries with the highest counts are kept in a sorted list
+ * that is updated with each message, so the top talkers can be read without
+ * scanning the table.
+ */
+
+#ifndef _traffic_h
+#define _traffic_h
+
+#include <Arduino.h>
+
+/// number of entries in hash table, must be a power of 2
+#ifndef TRAFFIC_SLOTS
+ #define TRAFFIC_SLOTS      256
+#endif
+
+/// max number of slots searched for a key
+#ifndef TRAFFIC_PROBES
+ #define TRAFFIC_PROBES     8
+#endif
+
+/// number of entries in list of top talkers
+#ifndef TRAFFIC_TOP
+ #define TRAFFIC_TOP        16
+#endif
+
+namespace traffic {
+
+/// MySensors commands are 3 bits
+const unsigned NUM_COMMANDS = 8;
+
+/// counters for one node/sensor/command/type
+struct TrafficEntry_t {
+    uint8_t node, sensor, command, type;
+    uint32_t count;     ///< number of messages, may be too high by up to `error`
+    uint32_t bytes;     ///< sum of payload lengths
+    uint32_t error;     ///< count of evicted entry that this one replaced
+};
+
+/// totals per command
+struct CommandTotals_t {
+    uint32_t count[NUM_COMMANDS];
+    uint32_t bytes[NUM_COMMANDS];
+};
+
+void count( uint8_t node, uint8_t sensor, uint8_t command, uint8_t type, uint8_t length );
+void clear();
+
+unsigned top( TrafficEntry_t* entries, unsigned max );
+unsigned node( uint8_t id, TrafficEntry_t* entries, unsigned max );
+void commands( CommandTotals_t& totals );
+unsigned used();
+uint32_t evictions();
+
+const char* commandName( uint8_t command );
+
+} // namespace traffic
+
+#endif // _traffic_h
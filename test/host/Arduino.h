@@ -0,0 +1,231 @@
+/**
+ * @file 		  Arduino.h
+ *
+ * Project		: Home automation
+ * Author		: Bernd Waldmann
+ * Created		: 16-Oct-2026
+ * Tabsize		: 4
+ *
+ * This Revision: $Id$
+ */
+
+/*
+   Copyright (C) 2024 Bernd Waldmann
+
+   This Source Code Form is subject to the terms of the Mozilla Public License, v. 2.0.
+   If a copy of the MPL was not distributed with this file, You can obtain one at http://mozilla.org/MPL/2.0/
+
+   SPDX-License-Identifier: MPL-2.0
+*/
+
+/**
+ * @brief Host replacement for the parts of the Arduino, ESP32 and FreeRTOS API
+ * that the portable modules and the benchmarks use, for the unit tests in [env:native].
+ *
+ * Tasks are std::threads. A test can give a thread a fixed task handle by
+ * setting `host::currentTask`, like the long-lived tasks on the ESP32.
+ * All critical sections share one recursive mutex. The tasks reported by
+ * `uxTaskGetSystemState()`, with their run time counters and stack high-water 
+ * marks, are made up by the test in `host::tasks`.
+ */
+
+#ifndef _host_arduino_h
+#define _host_arduino_h
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <mutex>
+#include <thread>
+
+#define PROGMEM
+
+#define log_e(fmt, ...) fprintf(stderr, "E: " fmt "\n", ##__VA_ARGS__)
+#define log_w(fmt, ...) fprintf(stderr, "W: " fmt "\n", ##__VA_ARGS__)
+#define log_i(fmt, ...) fprintf(stderr, "I: " fmt "\n", ##__VA_ARGS__)
+
+#if defined(__GLIBC__) && !(__GLIBC__ > 2 || __GLIBC_MINOR__ >= 38)
+/// not in older glibc, but in newlib on the ESP32
+inline size_t strlcpy( char* dst, const char* src, size_t size )
+{
+    size_t len = strlen( src );
+    if (size) {
+        size_t n = (len < size) ? len : size - 1;
+        memcpy( dst, src, n );
+        dst[n] = '\0';
+    }
+    return len;
+}
+#endif
+
+inline char* utoa( unsigned u, char* buf, int base )
+{
+    char tmp[33];
+    int n = 0;
+    do { 
+        unsigned d = u % base;
+        tmp[n++] = char(d < 10 ? '0' + d : 'a' + d - 10);
+        u /= base;
+    } while (u);
+    for (int i=0; i<n; i++) buf[i] = tmp[n-1-i];
+    buf[n] = '\0';
+    return buf;
+}
+
+/**
+ * @brief Enough of Arduino's String to run the old page renderer. Like the
+ * ESP32 version, strings of up to 11 characters are kept inline, longer ones
+ * get a heap buffer of exactly the length needed, which is re-allocated
+ * whenever the string grows beyond it.
+ */
+class String {
+public:
+    String( const char* s="" ) { concat( s, strlen(s) ); }
+    String( const String& s ) { concat( s.c_str(), s.length() ); }
+    explicit String( unsigned u ) { char b[12]; snprintf( b, sizeof b, "%u", u ); concat( b, strlen(b) ); }
+    explicit String( int i ) { char b[12]; snprintf( b, sizeof b, "%d", i ); concat( b, strlen(b) ); }
+    ~String() { if (_heap) free( _heap ); }
+
+    String& operator=( const String& s ) {
+        if (this != &s) { _len = 0; concat( s.c_str(), s.length() ); }
+        return *this;
+    }
+
+    bool reserve( unsigned size ) {
+        if (size <= _cap) return true;
+        char* p = (char*)realloc( _heap, size+1 );
+        if (!p) return false;
+        if (!_heap) memcpy( p, _sso, _len+1 );
+        _heap = p;
+        _cap = size;
+        return true;
+    }
+    bool concat( const char* s, unsigned n ) {
+        if (!reserve( _len + n )) return false;
+        memcpy( buffer() + _len, s, n );
+        _len += n;
+        buffer()[_len] = '\0';
+        return true;
+    }
+    String& operator+=( const String& s ) { concat( s.c_str(), s.length() ); return *this; }
+    String& operator+=( const char* s ) { concat( s, strlen(s) ); return *this; }
+    String& operator+=( unsigned u ) { return *this += String(u); }
+    String& operator+=( int i ) { return *this += String(i); }
+
+    int indexOf( char c, unsigned from=0 ) const {
+        if (from >= _len) return -1;
+        const char* p = strchr( c_str() + from, c );
+        return p ? int(p - c_str()) : -1;
+    }
+    String substring( unsigned from, unsigned to ) const {
+        String s;
+        if (to > _len) to = _len;
+        if (from < to) s.concat( c_str() + from, to - from );
+        return s;
+    }
+    String substring( unsigned from ) const { return substring( from, _len ); }
+
+    bool operator==( const char* s ) const { return strcmp( c_str(), s ) == 0; }
+    const char* c_str() const { return _heap ? _heap : _sso; }
+    unsigned length() const { return _len; }
+
+private:
+    char* buffer() { return _heap ? _heap : _sso; }
+    char _sso[12] = "";
+    char* _heap = nullptr;
+    unsigned _cap = sizeof(_sso) - 1;
+    unsigned _len = 0;
+};
+
+//----- FreeRTOS
+
+typedef struct HostTask* TaskHandle_t;
+typedef int BaseType_t;
+typedef unsigned UBaseType_t;
+typedef uint32_t TickType_t;
+
+#define pdTRUE          1
+#define portMAX_DELAY   0xFFFFFFFFu
+
+namespace host {
+    /// task handle of this thread, if null a unique one is made up
+    inline thread_local TaskHandle_t currentTask = nullptr;
+    /// shared by all critical sections
+    inline std::recursive_mutex critical;
+}
+
+inline TaskHandle_t xTaskGetCurrentTaskHandle()
+{
+    static thread_local char self;
+    return host::currentTask ? host::currentTask : (TaskHandle_t)&self;
+}
+
+inline void vTaskDelay( TickType_t ) { std::this_thread::yield(); }
+
+/// the host is treated as one core without interrupts
+#define portNUM_PROCESSORS              1
+inline BaseType_t xPortGetCoreID() { return 0; }
+#define portSET_INTERRUPT_MASK_FROM_ISR()       0u
+#define portCLEAR_INTERRUPT_MASK_FROM_ISR(irq)  ((void)(irq))
+
+//----- task list, for uxTaskGetSystemState()
+
+#define configUSE_TRACE_FACILITY        1
+#define configMAX_TASK_NAME_LEN         16
+/// there is no tick hook on the host, so modules use the run time counters
+#ifndef configGENERATE_RUN_TIME_STATS
+ #define configGENERATE_RUN_TIME_STATS  1
+#endif
+#define tskNO_AFFINITY                  0x7FFFFFFF
+
+typedef struct {
+    TaskHandle_t xHandle;
+    const char* pcTaskName;
+    uint32_t ulRunTimeCounter;
+    uint32_t usStackHighWaterMark;  ///< in bytes, as on the ESP32
+    BaseType_t xCoreID;             ///< core the task is pinned to, or tskNO_AFFINITY
+} TaskStatus_t;
+
+namespace host {
+    const unsigned MAX_TASKS = 64;
+    /// tasks that exist, as set up by a test
+    inline TaskStatus_t tasks[MAX_TASKS];
+    inline unsigned nTasks;
+    /// run time counter of the system, returned by uxTaskGetSystemState()
+    inline uint32_t totalRunTime;
+    /// idle task of each core
+    inline TaskHandle_t idleTasks[portNUM_PROCESSORS];
+}
+
+inline UBaseType_t uxTaskGetSystemState( TaskStatus_t* status, UBaseType_t max, uint32_t* totalRunTime )
+{
+    if (host::nTasks > max) return 0;
+    memcpy( status, host::tasks, host::nTasks * sizeof status[0] );
+    if (totalRunTime) *totalRunTime = host::totalRunTime;
+    return host::nTasks;
+}
+
+inline BaseType_t xTaskGetAffinity( TaskHandle_t h )
+{
+    for (unsigned i=0; i<host::nTasks; i++)
+        if (host::tasks[i].xHandle == h) return host::tasks[i].xCoreID;
+    return tskNO_AFFINITY;
+}
+
+inline TaskHandle_t xTaskGetIdleTaskHandleForCore( BaseType_t core ) { return host::idleTasks[core]; }
+
+typedef int portMUX_TYPE;
+#define portMUX_INITIALIZER_UNLOCKED    0
+#define portENTER_CRITICAL(mux)         ((void)(mux), host::critical.lock())
+#define portEXIT_CRITICAL(mux)          ((void)(mux), host::critical.unlock())
+
+typedef std::mutex StaticSemaphore_t;
+typedef std::mutex* SemaphoreHandle_t;
+inline SemaphoreHandle_t xSemaphoreCreateMutexStatic( StaticSemaphore_t* buf ) { return buf; }
+inline BaseType_t xSemaphoreTake( SemaphoreHandle_t m, TickType_t ) { m->lock(); return pdTRUE; }
+inline BaseType_t xSemaphoreGive( SemaphoreHandle_t m ) { m->unlock(); return pdTRUE; }
+
+#endif // _host_arduino_h
@@ -0,0 +1,92 @@
+/**
+ * @file 		  alloc_count.h
+ *
+ * Project		: Home automation
+ * Author		: Bernd Waldmann
+ * Created		: 16-Oct-2026
+ * Tabsize		: 4
+ *
+ * This Revision: $Id$
+ */
+
+/*
+   Copyright (C) 2024 Bernd Waldmann
+
+   This Source Code Form is subject to the terms of the Mozilla Public License, v. 2.0.
+   If a copy of the MPL was not distributed with this file, You can obtain one at http://mozilla.org/MPL/2.0/
+
+   SPDX-License-Identifier: MPL-2.0
+*/
+
+/**
+ * @brief Heap allocation counter for tests on the build host. Replaces
+ * operator new/new[] and, on glibc, malloc, calloc and realloc with versions
+ * that count calls while `host::counting` is set.
+ *
+ * Include in exactly one file of a test program.
+ */
+
+#ifndef _host_alloc_count_h
+#define _host_alloc_count_h
+
+#include <new>
+#include <stdlib.h>
+
+namespace host {
+    /// count allocations while this is set
+    inline bool counting;
+    /// # of allocations counted
+    inline unsigned allocations;
+}
+
+#ifdef __GLIBC__
+extern "C" void* __libc_malloc( size_t size );
+extern "C" void* __libc_calloc( size_t n, size_t size );
+extern "C" void* __libc_realloc( void* p, size_t size );
+
+extern "C" void* malloc( size_t size )
+{
+    if (host::counting) host::allocations++;
+    return __libc_malloc( size );
+}
+
+extern "C" void* calloc( size_t n, size_t size )
+{
+    if (host::counting) host::allocations++;
+    return __libc_calloc( n, size );
+}
+
+extern "C" void* realloc( void* p, size_t size )
+{
+    if (host::counting) host::allocations++;
+    return __libc_realloc( p, size );
+}
+
+static inline void* rawMalloc( size_t size ) { return __libc_malloc( size ); }
+#else
+static inline void* rawMalloc( size_t size ) { return malloc( size ); }
+#endif
+
+static void* counted( size_t size ) noexcept
+{
+    if (host::counting) host::allocations++;
+    return rawMalloc( size ? size : 1 );
+}
+
+static void* countedOrThrow( size_t size )
+{
+    void* p = counted( size );
+    if (!p) throw std::bad_alloc();
+    return p;
+}
+
+void* operator new( size_t size ) { return countedOrThrow( size ); }
+void* operator new[]( size_t size ) { return countedOrThrow( size ); }
+void* operator new( size_t size, const std::nothrow_t& ) noexcept { return counted( size ); }
+void* operator new[]( size_t size, const std::nothrow_t& ) noexcept { return counted( size ); }
+void operator delete( void* p ) noexcept { free( p ); }
+void operator delete[]( void* p ) noexcept { free( p ); }
+void operator delete( void* p, size_t ) noexcept { free( p ); }
+void operator delete[]( void* p, size_t ) noexcept { free( p ); }
+
+#endif // _host_alloc_count_h
@@ -0,0 +1,35 @@
+/**
+ * @file 		  esp_freertos_hooks.h
+ *
+ * Project		: Home automation
+ * Author		: Bernd Waldmann
+ * Created		: 16-Oct-2026
+ * Tabsize		: 4
+ *
+ * This Revision: $Id$
+ */
+
+/*
+   Copyright (C) 2024 Bernd Waldmann
+
+   This Source Code Form is subject to the terms of the Mozilla Public License, v. 2.0.
+   If a copy of the MPL was not distributed with this file, You can obtain one at http://mozilla.org/MPL/2.0/
+
+   SPDX-License-Identifier: MPL-2.0
+*/
+
+/**
+ * @brief Host replacement for the FreeRTOS hooks of ESP-IDF, for [env:native].
+ * There is no tick on the host, so a tick hook is never called.
+ */
+
+#ifndef _host_esp_freertos_hooks_h
+#define _host_esp_freertos_hooks_h
+
+#define ESP_OK  0
+
+typedef void (*esp_freertos_tick_cb_t)();
+
+inline int esp_register_freertos_tick_hook_for_cpu( esp_freertos_tick_cb_t, unsigned ) { return ESP_OK; }
+
+#endif // _host_esp_freertos_hooks_h
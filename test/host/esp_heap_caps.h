@@ -0,0 +1,48 @@
+/**
+ * @file 		  esp_heap_caps.h
+ *
+ * Project		: Home automation
+ * Author		: Bernd Waldmann
+ * Created		: 16-Oct-2026
+ * Tabsize		: 4
+ *
+ * This Revision: $Id$
+ */
+
+/*
+   Copyright (C) 2024 Bernd Waldmann
+
+   This Source Code Form is subject to the terms of the Mozilla Public License, v. 2.0.
+   If a copy of the MPL was not distributed with this file, You can obtain one at http://mozilla.org/MPL/2.0/
+
+   SPDX-License-Identifier: MPL-2.0
+*/
+
+/**
+ * @brief Host replacement for the heap functions of ESP-IDF, for [env:native].
+ * They return the values that a test sets in `host::heap`.
+ */
+
+#ifndef _host_esp_heap_caps_h
+#define _host_esp_heap_caps_h
+
+#include <stddef.h>
+#include <stdint.h>
+
+#define MALLOC_CAP_8BIT     (1 << 2)
+
+namespace host {
+    /// heap metrics, as set up by a test
+    struct Heap_t {
+        size_t free;        ///< [bytes] free heap
+        size_t largest;     ///< [bytes] largest free block
+        size_t minFree;     ///< [bytes] lowest free heap since startup
+    };
+    inline Heap_t heap;
+}
+
+inline size_t heap_caps_get_free_size( uint32_t ) { return host::heap.free; }
+inline size_t heap_caps_get_largest_free_block( uint32_t ) { return host::heap.largest; }
+inline size_t heap_caps_get_minimum_free_size( uint32_t ) { return host::heap.minFree; }
+
+#endif // _host_esp_heap_caps_h
@@ -0,0 +1,31 @@
+/**
+ * @file 		  esp_idf_version.h
+ *
+ * Project		: Home automation
+ * Author		: Bernd Waldmann
+ * Created		: 16-Oct-2026
+ * Tabsize		: 4
+ *
+ * This Revision: $Id$
+ */
+
+/*
+   Copyright (C) 2024 Bernd Waldmann
+
+   This Source Code Form is subject to the terms of the Mozilla Public License, v. 2.0.
+   If a copy of the MPL was not distributed with this file, You can obtain one at http://mozilla.org/MPL/2.0/
+
+   SPDX-License-Identifier: MPL-2.0
+*/
+
+/**
+ * @brief Host replacement for the ESP-IDF version macros, for [env:native]
+ */
+
+#ifndef _host_esp_idf_version_h
+#define _host_esp_idf_version_h
+
+#define ESP_IDF_VERSION_VAL(major, minor, patch)    (((major) << 16) | ((minor) << 8) | (patch))
+#define ESP_IDF_VERSION     ESP_IDF_VERSION_VAL(5, 1, 0)
+
+#endif // _host_esp_idf_version_h
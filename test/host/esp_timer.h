@@ -0,0 +1,45 @@
+/**
+ * @file 		  esp_timer.h
+ *
+ * Project		: Home automation
+ * Author		: Bernd Waldmann
+ * Created		: 16-Oct-2026
+ * Tabsize		: 4
+ *
+ * This Revision: $Id$
+ */
+
+/*
+   Copyright (C) 2024 Bernd Waldmann
+
+   This Source Code Form is subject to the terms of the Mozilla Public License, v. 2.0.
+   If a copy of the MPL was not distributed with this file, You can obtain one at http://mozilla.org/MPL/2.0/
+
+   SPDX-License-Identifier: MPL-2.0
+*/
+
+/**
+ * @brief Host replacement for esp_timer_get_time(), for [env:native]
+ *
+ * A test can let time pass without waiting, by adding to `host::timeOffset`.
+ */
+
+#ifndef _host_esp_timer_h
+#define _host_esp_timer_h
+
+#include <stdint.h>
+#include <chrono>
+
+namespace host {
+    /// [us] added to the time returned by esp_timer_get_time()
+    inline int64_t timeOffset;
+}
+
+/// [us] since some fixed point in time
+inline int64_t esp_timer_get_time()
+{
+    using namespace std::chrono;
+    return duration_cast<microseconds>( steady_clock::now().time_since_epoch() ).count() + host::timeOffset;
+}
+
+#endif // _host_esp_timer_h
@@ -0,0 +1,206 @@
+/**
+ * @file 		  test_main.cpp
+ *
+ * Project		: Home automation
+ * Author		: Bernd Waldmann
+ * Created		: 16-Oct-2026
+ * Tabsize		: 4
+ *
+ * This Revision: $Id$
+ */
+
+/*
+   Copyright (C) 2024 Bernd Waldmann
+
+   This Source Code Form is subject to the terms of the Mozilla Public License, v. 2.0.
+   If a copy of the MPL was not distributed with this file, You can obtain one at http://mozilla.org/MPL/2.0/
+
+   SPDX-License-Identifier: MPL-2.0
+*/
+
+/**
+ * @brief CPU load from FreeRTOS run time counters: the test makes up the
+ * task list and advances the counters by known amounts between samples,
+ * as if one second of run time (1000000 counts) had passed.
+ *
+ * The tests run in order and build on each other's task list.
+ *
+ * `pio test -e native -f test_cpuload`
+ */
+
+#include <unity.h>
+#include "cpuload.h"
+
+const uint32_t SECOND = 1000000;
+
+static cpuload::TaskLoad_t loads[host::MAX_TASKS];
+
+
+void setUp() {}
+void tearDown() {}
+
+
+static TaskHandle_t handle( unsigned i )
+{
+    return (TaskHandle_t)(uintptr_t)(0x1000 + 0x100 * i);
+}
+
+
+static void addTask( unsigned i, const char* name, uint32_t runTime, BaseType_t core = tskNO_AFFINITY )
+{
+    host::tasks[host::nTasks++] = TaskStatus_t{ handle(i), name, runTime, 1000, core };
+}
+
+
+static void removeTask( const char* name )
+{
+    for (unsigned i=0; i<host::nTasks; i++) {
+        if (strcmp( host::tasks[i].pcTaskName, name ) != 0) continue;
+        host::tasks[i] = host::tasks[--host::nTasks];
+        return;
+    }
+}
+
+
+/// let one second pass, in which the named task runs for `runTime`
+static void run( const char* name, uint32_t runTime )
+{
+    for (unsigned i=0; i<host::nTasks; i++)
+        if (strcmp( host::tasks[i].pcTaskName, name ) == 0) host::tasks[i].ulRunTimeCounter += runTime;
+}
+
+
+static const cpuload::TaskLoad_t* find( const char* name, unsigned n )
+{
+    for (unsigned i=0; i<n; i++)
+        if (strcmp( loads[i].name, name ) == 0) return &loads[i];
+    return nullptr;
+}
+
+
+/// per core and per task, in 0.1%, sorted by load
+void test_loads()
+{
+    // 5 s since startup, 60% idle
+    addTask( 0, "IDLE0", 3 * SECOND );
+    addTask( 1, "loopTask", SECOND, 1 );
+    addTask( 2, "httpd", SECOND / 2 );
+    addTask( 3, "mysensors", SECOND / 2, 0 );
+    host::totalRunTime = 5 * SECOND;
+    host::idleTasks[0] = handle(0);
+    cpuload::begin();
+    cpuload::sample();
+    // the first sample only claims the tasks
+    TEST_ASSERT_EQUAL_UINT32( 0, cpuload::tasks( loads, host::MAX_TASKS ) );
+
+    host::totalRunTime += SECOND;
+    run( "IDLE0", 600000 );
+    run( "loopTask", 250000 );
+    run( "httpd", 100000 );
+    run( "mysensors", 50000 );
+    cpuload::sample();
+
+    cpuload::CoreLoad_t c;
+    cpuload::core( 0, c );
+    TEST_ASSERT_EQUAL_UINT32( 400, c.now );
+    TEST_ASSERT_EQUAL_UINT32( 400, c.avg );
+    TEST_ASSERT_EQUAL_UINT32( 400, c.periodMax );
+
+    unsigned n = cpuload::tasks( loads, host::MAX_TASKS );
+    TEST_ASSERT_EQUAL_UINT32( 4, n );
+    const char* order[] = { "IDLE0", "loopTask", "httpd", "mysensors" };
+    const uint16_t permille[] = { 600, 250, 100, 50 };
+    for (unsigned i=0; i<4; i++) {
+        TEST_ASSERT_EQUAL_STRING( order[i], loads[i].name );
+        TEST_ASSERT_EQUAL_UINT32( permille[i], loads[i].now );
+        TEST_ASSERT_EQUAL_UINT32( permille[i], loads[i].avg );
+    }
+    TEST_ASSERT_EQUAL_INT( 1, loads[1].core );
+    TEST_ASSERT_EQUAL_INT( -1, loads[2].core );
+}
+
+
+/// with a smaller array, only the busiest tasks are returned
+void test_truncated()
+{
+    TEST_ASSERT_EQUAL_UINT32( 2, cpuload::tasks( loads, 2 ) );
+    TEST_ASSERT_EQUAL_STRING( "IDLE0", loads[0].name );
+    TEST_ASSERT_EQUAL_STRING( "loopTask", loads[1].name );
+    TEST_ASSERT_EQUAL_UINT32( 0, cpuload::tasks( loads, 0 ) );
+}
+
+
+/// a task started since the last sample is not charged the run time it 
+/// had before, it shows up after a full interval
+void test_new_task()
+{
+    addTask( 4, "ota", 3 * SECOND / 10 );
+    host::totalRunTime += SECOND;
+    run( "IDLE0", 700000 );
+    run( "loopTask", 200000 );
+    cpuload::sample();
+    TEST_ASSERT_NULL( find( "ota", cpuload::tasks( loads, host::MAX_TASKS ) ) );
+
+    host::totalRunTime += SECOND;
+    run( "IDLE0", 700000 );
+    run( "ota", 100000 );
+    run( "loopTask", 200000 );
+    cpuload::sample();
+    const cpuload::TaskLoad_t* ota = find( "ota", cpuload::tasks( loads, host::MAX_TASKS ) );
+    TEST_ASSERT_NOT_NULL( ota );
+    TEST_ASSERT_EQUAL_UINT32( 100, ota->now );
+    TEST_ASSERT_EQUAL_UINT32( 100, ota->avg );
+
+    cpuload::CoreLoad_t c;
+    cpuload::core( 0, c );
+    TEST_ASSERT_EQUAL_UINT32( 300, c.now );
+    TEST_ASSERT_EQUAL_UINT32( 400, c.periodMax );
+}
+
+
+/// the slot of a deleted task is freed, so all CPULOAD_MAX_TASKS slots can
+/// be used by the tasks that exist
+void test_slot_freed()
+{
+    removeTask( "httpd" );
+    host::totalRunTime += SECOND;
+    run( "IDLE0", SECOND );
+    cpuload::sample();
+    unsigned n = cpuload::tasks( loads, host::MAX_TASKS );
+    TEST_ASSERT_EQUAL_UINT32( 4, n );
+    TEST_ASSERT_NULL( find( "httpd", n ) );
+
+    for (unsigned i=host::nTasks; i<CPULOAD_MAX_TASKS; i++) addTask( 10 + i, "worker", 0 );
+    for (int k=0; k<2; k++) {
+        host::totalRunTime += SECOND;
+        run( "IDLE0", SECOND );
+        cpuload::sample();
+    }
+    TEST_ASSERT_EQUAL_UINT32( CPULOAD_MAX_TASKS, cpuload::tasks( loads, host::MAX_TASKS ) );
+}
+
+
+/// with more tasks than slots, nothing is measured, and loads stay as they were
+void test_too_many_tasks()
+{
+    cpuload::CoreLoad_t before, after;
+    cpuload::core( 0, before );
+    addTask( 60, "extra", 0 );
+    host::totalRunTime += SECOND;
+    cpuload::sample();
+    cpuload::core( 0, after );
+    TEST_ASSERT_EQUAL_UINT32( before.now, after.now );
+    TEST_ASSERT_EQUAL_UINT32( before.avg, after.avg );
+}
+
+
+int main( int argc, char** argv )
+{
+    UNITY_BEGIN();
+    RUN_TEST( test_loads );
+    RUN_TEST( test_truncated );
+    RUN_TEST( test_new_task );
+    RUN_TEST( test_slot_freed );
+    RUN_TEST( test_too_many_tasks );
+    return UNITY_END();
+}
@@ -0,0 +1,123 @@
+/**
+ * @file 		  test_main.cpp
+ *
+ * Project		: Home automation
+ * Author		: Bernd Waldmann
+ * Created		: 16-Oct-2026
+ * Tabsize		: 4
+ *
+ * This Revision: $Id$
+ */
+
+/*
+   Copyright (C) 2024 Bernd Waldmann
+
+   This Source Code Form is subject to the terms of the Mozilla Public License, v. 2.0.
+   If a copy of the MPL was not distributed with this file, You can obtain one at http://mozilla.org/MPL/2.0/
+
+   SPDX-License-Identifier: MPL-2.0
+*/
+
+/**
+ * @brief Duplicate detection: retransmitted copies are recognized, messages
+ * that a node sends periodically with the same payload are not, and a
+ * collision in the cache only replaces the older entry.
+ *
+ * Each test uses its own hashes, so they do not see each other's entries.
+ *
+ * `pio test -e native -f test_dedup`
+ */
+
+#include <unity.h>
+#include "dedup.h"
+
+const uint32_t MS = 1000;      // times are in us
+const uint32_t WINDOW = DEDUP_WINDOW_MS * MS;
+
+
+void setUp() {}
+void tearDown() {}
+
+
+/// a copy sent again because the ACK was lost is a duplicate, a new value is not
+void test_retransmit()
+{
+    const char on[] = "1", off[] = "0";
+    uint32_t h = dedup::hash( 12, 3, 1, 2, on, 1 );
+    uint32_t t = 5000 * MS;
+
+    TEST_ASSERT_EQUAL_UINT32( h, dedup::hash( 12, 3, 1, 2, on, 1 ) );
+    TEST_ASSERT_FALSE( dedup::isDuplicate( h, t ) );
+    TEST_ASSERT_TRUE( dedup::isDuplicate( h, t + 20*MS ) );
+    TEST_ASSERT_TRUE( dedup::isDuplicate( h, t + 60*MS ) );
+
+    // same payload from another node or sensor, or another payload, is a different message
+    TEST_ASSERT_FALSE( dedup::isDuplicate( dedup::hash( 13, 3, 1, 2, on, 1 ), t + 70*MS ) );
+    TEST_ASSERT_FALSE( dedup::isDuplicate( dedup::hash( 12, 4, 1, 2, on, 1 ), t + 80*MS ) );
+    TEST_ASSERT_FALSE( dedup::isDuplicate( dedup::hash( 12, 3, 1, 2, off, 1 ), t + 90*MS ) );
+}
+
+
+/// the same value sent every second is never a duplicate
+void test_periodic_same_payload()
+{
+    const char temp[] = "21.5";
+    uint32_t h = dedup::hash( 20, 1, 1, 0, temp, 4 );
+    uint32_t t = 10000 * MS;
+
+    for (unsigned i=0; i<60; i++)
+        TEST_ASSERT_FALSE( dedup::isDuplicate( h, t + i * 1000*MS ) );
+}
+
+
+/// the window starts at the first copy, duplicates do not extend it
+void test_window_not_extended()
+{
+    uint32_t h = 0x5a5a0001;
+    uint32_t t = 100000 * MS;
+
+    TEST_ASSERT_FALSE( dedup::isDuplicate( h, t ) );
+    TEST_ASSERT_TRUE( dedup::isDuplicate( h, t + WINDOW - 50*MS ) );
+    // less than a window after the duplicate, but a window after the first copy
+    TEST_ASSERT_FALSE( dedup::isDuplicate( h, t + WINDOW ) );
+    TEST_ASSERT_TRUE( dedup::isDuplicate( h, t + WINDOW + 10*MS ) );
+}
+
+
+/// two hashes in the same slot: the newer one replaces the older one, 
+/// so a copy of the older one is missed, but nothing is wrongly a duplicate
+void test_collision_replaces_entry()
+{
+    uint32_t a = 0x00000007, b = a + DEDUP_SLOTS;  // same slot, high bits are 0
+    uint32_t t = 200000 * MS;
+
+    TEST_ASSERT_FALSE( dedup::isDuplicate( a, t ) );
+    TEST_ASSERT_FALSE( dedup::isDuplicate( b, t + 1*MS ) );
+    TEST_ASSERT_TRUE( dedup::isDuplicate( b, t + 2*MS ) );
+    TEST_ASSERT_FALSE( dedup::isDuplicate( a, t + 3*MS ) );    // missed
+    TEST_ASSERT_FALSE( dedup::isDuplicate( b, t + 4*MS ) );    // replaced again
+}
+
+
+/// times are the low 32 bits of a 64-bit us counter, and wrap after 71 minutes
+void test_time_wraps()
+{
+    uint32_t h = 0x5a5a0002;
+    uint32_t t = 0xFFFFFFFF - 10*MS;
+
+    TEST_ASSERT_FALSE( dedup::isDuplicate( h, t ) );
+    TEST_ASSERT_TRUE( dedup::isDuplicate( h, t + 20*MS ) );
+    TEST_ASSERT_FALSE( dedup::isDuplicate( h, t + WINDOW + 20*MS ) );
+}
+
+
+int main( int argc, char** argv )
+{
+    UNITY_BEGIN();
+    RUN_TEST( test_retransmit );
+    RUN_TEST( test_periodic_same_payload );
+    RUN_TEST( test_window_not_extended );
+    RUN_TEST( test_collision_replaces_entry );
+    RUN_TEST( test_time_wraps );
+    return UNITY_END();
+}
@@ -0,0 +1,170 @@
+/**
+ * @file 		  test_main.cpp
+ *
+ * Project		: Home automation
+ * Author		: Bernd Waldmann
+ * Created		: 16-Oct-2026
+ * Tabsize		: 4
+ *
+ * This Revision: $Id$
+ */
+
+/*
+   Copyright (C) 2024 Bernd Waldmann
+
+   This Source Code Form is subject to the terms of the Mozilla Public License, v. 2.0.
+   If a copy of the MPL was not distributed with this file, You can obtain one at http://mozilla.org/MPL/2.0/
+
+   SPDX-License-Identifier: MPL-2.0
+*/
+
+/**
+ * @brief Measurement harness for the figures quoted in stats.h: sizes of the
+ * statistics structures, and the time of `snapshot()`, `markActiveDirty()` and
+ * `table::render()` with 24 active nodes. Times are for the build host, not the ESP32.
+ *
+ * For comparison, it also measures the layout and the table renderer from before
+ * per-node records: three parallel `unsigned[256]` arrays, and fixed table rows
+ * 0, 20 and 100..190 whether or not a node in them is active.
+ *
+ * `pio test -e native -f test_footprint`
+ */
+
+#include <unity.h>
+#include <stdio.h>
+#include <chrono>
+#include "stats.h"
+#include "table.h"
+
+const unsigned REPEAT = 10000;
+
+static StatsSnapshot_t snap;
+static char buf[8192];
+
+
+//----- before: parallel arrays, fixed rows
+
+/// per-node counters as they were stored before
+struct BeforeCounters_t {
+    RxTxStats_t rxtxStats;
+    ArcStats_t arcStats;
+    unsigned nMessagesRx[256];
+    unsigned nMessagesTx[256];
+    unsigned nRetries[256];
+};
+
+static BeforeCounters_t before;
+
+
+/// table row as it was rendered before, from the parallel arrays
+static void beforeRow( TextWriter& out, unsigned y, time_t nSecsElapsed )
+{
+    out.print("<tr><th>"); out.print(y); out.print(":</th>");
+    for (unsigned x=0; x<10; x++) {
+        unsigned totalMsgsRx = before.nMessagesRx[y+x];
+        out.print("<td id='n"); out.print(y+x); out.print("'>");
+        if (totalMsgsRx > 0) {
+            out.print("<b>"); out.print(totalMsgsRx); out.print("</b>");
+            if (nSecsElapsed) {
+                out.print("&ensp;<span class='mph'>"); out.print(unsigned((totalMsgsRx * 3600uL) / nSecsElapsed)); 
+                out.print("/h</span>");
+            }
+        }
+        unsigned totalMsgsTx = before.nMessagesTx[y+x];
+        if (totalMsgsTx > 0) {
+            unsigned success = (100 * totalMsgsTx) / (totalMsgsTx + before.nRetries[y+x]);
+            out.print("<br/><span class='suc'>"); out.print(success); out.print("%</span>");
+            stats::ArcPercentiles_t p = stats::nodeArcPercentiles( y+x );
+            out.print("<br/><span class='arc'>"); out.print(unsigned(p.p50));
+            out.print("/"); out.print(unsigned(p.p95));
+            out.print("/"); out.print(unsigned(p.max));
+            if (p.atLimit) { out.print(" "); out.print(unsigned(p.atLimit)); out.print("%"); }
+            out.print("</span>");
+        }
+        out.print("</td>");
+    }
+    out.print("</tr>\n");
+}
+
+
+/// table as it was rendered before: rows 0, 20 and 100..190
+static void beforeRender( TextWriter& out, time_t nSecsElapsed )
+{
+    out.print("<table><tr><th> </th>");
+    for (unsigned x=0; x<10; x++) {
+        out.print("<th>&ensp;+"); out.print(x); out.print("</th>");
+    }
+    out.print("</tr>\n");
+    beforeRow( out, 0, nSecsElapsed );
+    beforeRow( out, 20, nSecsElapsed );
+    for (unsigned y=100; y<200; y+=10) beforeRow( out, y, nSecsElapsed );
+    out.print("</table>");
+}
+
+
+void setUp() {}
+void tearDown() {}
+
+
+void test_sizes()
+{
+    printf( "before: per-node arrays %u bytes, counters %u bytes\n",
+        unsigned(sizeof(before.nMessagesRx) * 3), unsigned(sizeof(BeforeCounters_t)) );
+    printf( "after:  per-node records %u bytes, StatsCounters_t %u bytes, StatsSnapshot_t %u bytes\n",
+        unsigned(sizeof(StatsCounters_t::nodes)), unsigned(sizeof(StatsCounters_t)), unsigned(sizeof(StatsSnapshot_t)) );
+    TEST_ASSERT_EQUAL_UINT32( 256*3*4, sizeof(before.nMessagesRx) * 3 );
+    // 5 RX/TX counters, packets, retries, success, 16 histogram bins, 4 counters per node
+    TEST_ASSERT_EQUAL_UINT32( (5 + 3 + 16 + 256*4) * 4, sizeof(StatsCounters_t) );
+}
+
+
+template<typename Fn>
+static double microseconds( Fn fn )
+{
+    auto t0 = std::chrono::steady_clock::now();
+    for (unsigned i=0; i<REPEAT; i++) fn();
+    auto t1 = std::chrono::steady_clock::now();
+    return std::chrono::duration<double,std::micro>( t1 - t0 ).count() / REPEAT;
+}
+
+
+void test_timing()
+{
+    for (unsigned i=0; i<1000; i++) {
+        stats::countSent( i % 12, 1 );
+        stats::countReceived( i % 12 + 100 );
+    }
+    double tSnapshot = microseconds( []() { stats::snapshot( snap ); } );
+    double tDirty = microseconds( []() { stats::markActiveDirty(); } );
+    printf( "24 active nodes: snapshot() %.2f us, markActiveDirty() %.2f us\n", tSnapshot, tDirty );
+    TEST_ASSERT_EQUAL_UINT32( 1000, snap.arcStats.packets );
+
+    for (unsigned id=0; id<256; id++) {
+        before.nMessagesRx[id] = snap.nodes[id].rx;
+        before.nMessagesTx[id] = snap.nodes[id].tx;
+        before.nRetries[id] = snap.nodes[id].retries;
+    }
+    size_t lenBefore = 0, lenAfter = 0;
+    double tBefore = microseconds( [&]() { 
+        TextWriter out( buf, sizeof buf ); 
+        beforeRender( out, 3600 ); 
+        lenBefore = out.length(); 
+    });
+    double tAfter = microseconds( [&]() { 
+        TextWriter out( buf, sizeof buf ); 
+        table::render( out, snap, 3600 ); 
+        lenAfter = out.length();
+    });
+    printf( "24 active nodes: render() before %.2f us (%u bytes, 12 rows), after %.2f us (%u bytes, 4 rows)\n", 
+        tBefore, unsigned(lenBefore), tAfter, unsigned(lenAfter) );
+    TEST_ASSERT_TRUE( lenBefore > 0 && lenAfter > 0 );
+}
+
+
+int main( int argc, char** argv )
+{
+    UNITY_BEGIN();
+    RUN_TEST( test_sizes );
+    RUN_TEST( test_timing );
+    return UNITY_END();
+}
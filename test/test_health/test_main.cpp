@@ -0,0 +1,239 @@
+/**
+ * @file 		  test_main.cpp
+ *
+ * Project		: Home automation
+ * Author		: Bernd Waldmann
+ * Created		: 16-Oct-2026
+ * Tabsize		: 4
+ *
+ * This Revision: $Id$
+ */
+
+/*
+   Copyright (C) 2024 Bernd Waldmann
+
+   This Source Code Form is subject to the terms of the Mozilla Public License, v. 2.0.
+   If a copy of the MPL was not distributed with this file, You can obtain one at http://mozilla.org/MPL/2.0/
+
+   SPDX-License-Identifier: MPL-2.0
+*/
+
+/**
+ * @brief Stack and heap monitor: the test sets heap metrics and the task 
+ * list with stack high-water marks, and checks the warnings from `sample()`.
+ *
+ * Each test drains the warnings it caused, and sets up its own tasks.
+ *
+ * `pio test -e native -f test_health`
+ */
+
+#include <unity.h>
+#include <esp_heap_caps.h>
+#include "health.h"
+
+const uint32_t HEALTHY = 100000;    // [bytes] free heap, well above HEALTH_MIN_FREE_HEAP
+
+/// [ms] time passed to `sample()`
+static unsigned long t_now;
+
+
+static void sample()
+{
+    t_now += 60000;
+    health::sample( t_now );
+}
+
+
+/// set task list to only the idle task
+static void resetTasks()
+{
+    host::tasks[0] = TaskStatus_t{ (TaskHandle_t)(uintptr_t)0x1000, "IDLE0", 0, 1000, 0 };
+    host::nTasks = 1;
+}
+
+
+/// set task at index `i` of the task list, `id` makes up its handle
+static void setTask( unsigned i, unsigned id, const char* name, uint32_t stackLeft )
+{
+    host::tasks[i] = TaskStatus_t{ (TaskHandle_t)(uintptr_t)(0x1000 + 0x100 * id), name, 0, stackLeft, tskNO_AFFINITY };
+    if (i >= host::nTasks) host::nTasks = i + 1;
+}
+
+
+void setUp() 
+{
+    host::heap = { HEALTHY, HEALTHY, HEALTHY };
+    resetTasks();
+}
+
+void tearDown() {}
+
+
+/// get next warning, and check that there is one of this kind
+static health::Warning_t expect( health::Kind kind, bool cleared )
+{
+    health::Warning_t w;
+    TEST_ASSERT_TRUE( health::nextWarning( w ) );
+    TEST_ASSERT_EQUAL( kind, w.kind );
+    TEST_ASSERT_EQUAL( cleared, w.cleared );
+    return w;
+}
+
+
+static void expectNone()
+{
+    health::Warning_t w;
+    TEST_ASSERT_FALSE( health::nextWarning( w ) );
+}
+
+
+/// free heap warns below the limit, and clears only 25% above it
+void test_free_heap_hysteresis()
+{
+    sample();
+    expectNone();
+
+    host::heap.free = host::heap.largest = HEALTH_MIN_FREE_HEAP - 1000;
+    sample();
+    TEST_ASSERT_EQUAL_UINT32( HEALTH_MIN_FREE_HEAP - 1000, expect( health::FREE_HEAP, false ).value );
+    sample();
+    expectNone();
+
+    host::heap.free = host::heap.largest = HEALTH_MIN_FREE_HEAP + HEALTH_MIN_FREE_HEAP / 8;
+    sample();
+    expectNone();
+
+    host::heap.free = host::heap.largest = HEALTH_MIN_FREE_HEAP + HEALTH_MIN_FREE_HEAP / 2;
+    sample();
+    TEST_ASSERT_EQUAL_UINT32( HEALTH_MIN_FREE_HEAP + HEALTH_MIN_FREE_HEAP / 2, expect( health::FREE_HEAP, true ).value );
+    expectNone();
+}
+
+
+/// fragmentation warns above the limit, and clears only below 80% of it
+void test_fragmentation_hysteresis()
+{
+    // largest block is 30% of free heap: 70% fragmented
+    host::heap.largest = HEALTHY * 3 / 10;
+    sample();
+    TEST_ASSERT_EQUAL_UINT32( 700, expect( health::FRAGMENTATION, false ).value );
+
+    // 55%, below the limit but not by enough
+    host::heap.largest = HEALTHY * 45 / 100;
+    sample();
+    expectNone();
+
+    // 40%
+    host::heap.largest = HEALTHY * 6 / 10;
+    sample();
+    TEST_ASSERT_EQUAL_UINT32( 400, expect( health::FRAGMENTATION, true ).value );
+    expectNone();
+
+    health::HeapSample_t s;
+    TEST_ASSERT_EQUAL_UINT32( 1, health::history( &s, 1 ) );
+    TEST_ASSERT_EQUAL_UINT32( 400, s.fragmentation );
+    TEST_ASSERT_EQUAL_UINT32( HEALTHY, s.free );
+}
+
+
+/// a task low on stack is warned about once, and again if its handle is 
+/// reused by a new task
+void test_stack_once_per_task()
+{
+    setTask( 1, 1, "loopTask", 4000 );
+    setTask( 2, 2, "mysensors", HEALTH_MIN_STACK - 100 );
+    sample();
+    health::Warning_t w = expect( health::STACK, false );
+    TEST_ASSERT_EQUAL_STRING( "mysensors", w.task );
+    TEST_ASSERT_EQUAL_UINT32( HEALTH_MIN_STACK - 100, w.value );
+    expectNone();
+
+    sample();
+    sample();
+    expectNone();
+
+    // stacks are listed with the smallest headroom first
+    health::TaskStack_t st[4];
+    TEST_ASSERT_EQUAL_UINT32( 3, health::stacks( st, 4 ) );
+    TEST_ASSERT_EQUAL_STRING( "mysensors", st[0].name );
+    TEST_ASSERT_EQUAL_STRING( "IDLE0", st[1].name );
+    TEST_ASSERT_EQUAL_STRING( "loopTask", st[2].name );
+    TEST_ASSERT_EQUAL_UINT32( 1, health::stacks( st, 1 ) );
+    TEST_ASSERT_EQUAL_STRING( "mysensors", st[0].name );
+
+    // task deleted, a new one gets the same handle
+    setTask( 2, 2, "ota", HEALTH_MIN_STACK - 200 );
+    sample();
+    w = expect( health::STACK, false );
+    TEST_ASSERT_EQUAL_STRING( "ota", w.task );
+    expectNone();
+
+    // the old task is gone, and forgotten: if it comes back, it is checked again
+    host::nTasks = 2;
+    sample();
+    setTask( 2, 2, "mysensors", HEALTH_MIN_STACK - 100 );
+    sample();
+    TEST_ASSERT_EQUAL_STRING( "mysensors", expect( health::STACK, false ).task );
+    expectNone();
+}
+
+
+/// warnings beyond the queue are counted, and reported once as DROPPED
+void test_queue_overflow()
+{
+    static const char* names[] = { "t0","t1","t2","t3","t4","t5","t6","t7","t8","t9","t10" };
+    const unsigned N = sizeof names / sizeof names[0];
+    for (unsigned i=0; i<N; i++) setTask( 1 + i, 20 + i, names[i], 100 + i );
+    host::heap.free = host::heap.largest = HEALTH_MIN_FREE_HEAP / 2;
+    uint32_t droppedBefore = health::dropped();
+    sample();
+
+    // 11 stack warnings and 1 heap warning, 8 fit in the queue
+    unsigned nStack = 0;
+    health::Warning_t w;
+    while (health::nextWarning( w ) && w.kind == health::STACK) nStack++;
+    TEST_ASSERT_EQUAL_UINT32( 8, nStack );
+    TEST_ASSERT_EQUAL( health::DROPPED, w.kind );
+    TEST_ASSERT_EQUAL_UINT32( N + 1 - 8, w.value );
+    TEST_ASSERT_EQUAL_UINT32( N + 1 - 8, health::dropped() - droppedBefore );
+    expectNone();
+
+    // recovery still gets through
+    host::heap.free = host::heap.largest = HEALTHY;
+    sample();
+    expect( health::FREE_HEAP, true );
+    expectNone();
+}
+
+
+/// after the ring has wrapped, history has the most recent samples, oldest first
+void test_history_wraps()
+{
+    for (unsigned i=0; i < HEALTH_HISTORY + 10; i++) {
+        host::heap.free = host::heap.largest = HEALTHY + i;
+        sample();
+    }
+    static health::HeapSample_t s[HEALTH_HISTORY + 1];
+    TEST_ASSERT_EQUAL_UINT32( HEALTH_HISTORY, health::history( s, HEALTH_HISTORY + 1 ) );
+    for (unsigned k=0; k<HEALTH_HISTORY; k++) {
+        TEST_ASSERT_EQUAL_UINT32( HEALTHY + 10 + k, s[k].free );
+        if (k) TEST_ASSERT_EQUAL_UINT32( s[k-1].t + 60, s[k].t );
+    }
+    TEST_ASSERT_EQUAL_UINT32( t_now / 1000, s[HEALTH_HISTORY-1].t );
+
+    TEST_ASSERT_EQUAL_UINT32( 3, health::history( s, 3 ) );
+    TEST_ASSERT_EQUAL_UINT32( HEALTHY + HEALTH_HISTORY + 7, s[0].free );
+    TEST_ASSERT_EQUAL_UINT32( HEALTHY + HEALTH_HISTORY + 9, s[2].free );
+}
+
+
+int main( int argc, char** argv )
+{
+    UNITY_BEGIN();
+    RUN_TEST( test_free_heap_hysteresis );
+    RUN_TEST( test_fragmentation_hysteresis );
+    RUN_TEST( test_stack_once_per_task );
+    RUN_TEST( test_queue_overflow );
+    RUN_TEST( test_history_wraps );
+    return UNITY_END();
+}
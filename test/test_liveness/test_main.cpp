@@ -0,0 +1,174 @@
+/**
+ * @file 		  test_main.cpp
+ *
+ * Project		: Home automation
+ * Author		: Bernd Waldmann
+ * Created		: 16-Oct-2026
+ * Tabsize		: 4
+ *
+ * This Revision: $Id$
+ */
+
+/*
+   Copyright (C) 2024 Bernd Waldmann
+
+   This Source Code Form is subject to the terms of the Mozilla Public License, v. 2.0.
+   If a copy of the MPL was not distributed with this file, You can obtain one at http://mozilla.org/MPL/2.0/
+
+   SPDX-License-Identifier: MPL-2.0
+*/
+
+/**
+ * @brief Offline detection: nodes learn their interval, go offline when
+ * silent for too long, and come back online with their next message.
+ * Overdue nodes are returned in order of their deadlines.
+ *
+ * Time is advanced with `host::timeOffset`. The real clock keeps running
+ * meanwhile, so checks keep a few seconds from each deadline.
+ *
+ * `pio test -e native -f test_liveness`
+ */
+
+#include <unity.h>
+#include <esp_timer.h>
+#include "liveness.h"
+
+const int64_t S = 1000000;      // us
+const uint32_t INTERVAL = 200;  // s, timeout is above LIVENESS_MIN_TIMEOUT_S
+const uint8_t NODES[] = { 1, 2, 3, 4, 5 };
+
+/// [s] test time, since start of `test_learning()`
+static int64_t t;
+/// [s] end of learning
+static int64_t t0;
+/// [s] deadline of the last node still online after `test_offline_in_deadline_order()`
+static int64_t lastDeadline;
+
+
+void setUp() {}
+void tearDown() {}
+
+
+/// let time pass until `t` seconds after the start
+static void at( int64_t seconds )
+{
+    host::timeOffset += (seconds - t) * S;
+    t = seconds;
+}
+
+
+static unsigned numOffline()
+{
+    uint32_t bitmap[256/32];
+    return liveness::offline( bitmap );
+}
+
+
+/// after LIVENESS_MIN_REPORTS intervals, a node gets a timeout
+void test_learning()
+{
+    liveness::Event_t ev;
+    for (unsigned i=0; i<LIVENESS_MIN_REPORTS; i++) {
+        at( i * INTERVAL );
+        for (uint8_t id : NODES) liveness::seen( id );
+        // a burst of messages is one report
+        at( i * INTERVAL + 2 );
+        for (uint8_t id : NODES) liveness::seen( id );
+        liveness::NodeLiveness_t l = liveness::node( 1 );
+        TEST_ASSERT_EQUAL( liveness::LEARNING, l.state );
+        TEST_ASSERT_EQUAL_UINT32( 0, l.timeout );
+    }
+    at( LIVENESS_MIN_REPORTS * INTERVAL );
+    for (uint8_t id : NODES) liveness::seen( id );
+
+    liveness::NodeLiveness_t l = liveness::node( 1 );
+    TEST_ASSERT_EQUAL( liveness::ONLINE, l.state );
+    TEST_ASSERT_UINT32_WITHIN( 1, INTERVAL, l.interval );
+    TEST_ASSERT_EQUAL_UINT32( LIVENESS_FACTOR * l.interval, l.timeout );
+    TEST_ASSERT_FALSE( liveness::nextEvent( ev ) );
+
+    // nodes that never had a message, and nodes without an id, are unknown
+    TEST_ASSERT_EQUAL( liveness::LEARNING, liveness::node( 6 ).state );
+    TEST_ASSERT_EQUAL_UINT32( UINT32_MAX, liveness::node( 6 ).silent );
+    liveness::seen( 255 );
+    TEST_ASSERT_EQUAL_UINT32( UINT32_MAX, liveness::node( 255 ).silent );
+}
+
+
+/// overdue nodes go offline in order of their deadlines, not of ids or of insertion
+void test_offline_in_deadline_order()
+{
+    const uint8_t order[] = { 5, 3, 1, 4, 2 };
+    int64_t deadline[5];
+    t0 = t;
+    // a message after a short time lowers the interval, so the node's deadline 
+    // moves before those of the nodes not yet seen again
+    for (unsigned i=0; i<5; i++) {
+        at( t0 + 20 * (i+1) );
+        liveness::seen( order[i] );
+        deadline[i] = t + liveness::node( order[i] ).timeout;
+        if (i) TEST_ASSERT_LESS_THAN( deadline[i], deadline[i-1] );
+    }
+    TEST_ASSERT_LESS_THAN( t0 + LIVENESS_FACTOR * INTERVAL, deadline[0] );
+    uint32_t changes = liveness::changes();
+    liveness::Event_t ev;
+
+    at( deadline[0] - 5 );
+    TEST_ASSERT_FALSE( liveness::nextEvent( ev ) );
+    const int64_t now = deadline[3] + 5;
+    at( now );
+    for (unsigned i=0; i<4; i++) {
+        TEST_ASSERT_TRUE( liveness::nextEvent( ev ) );
+        TEST_ASSERT_EQUAL_UINT8( order[i], ev.id );
+        TEST_ASSERT_FALSE( ev.online );
+        TEST_ASSERT_UINT32_WITHIN( 2, now - (t0 + 20 * (i+1)), ev.silent );
+    }
+    TEST_ASSERT_FALSE( liveness::nextEvent( ev ) );
+    TEST_ASSERT_EQUAL( liveness::OFFLINE, liveness::node( 5 ).state );
+    TEST_ASSERT_EQUAL( liveness::ONLINE, liveness::node( 2 ).state );
+    TEST_ASSERT_EQUAL( 4, numOffline() );
+    TEST_ASSERT_NOT_EQUAL( changes, liveness::changes() );
+    lastDeadline = deadline[4];
+}
+
+
+/// an offline node comes back with its next message, and can go offline again
+void test_back_online()
+{
+    liveness::Event_t ev;
+    at( t + 5 );
+    const int64_t back = t;
+    liveness::seen( 3 );
+
+    TEST_ASSERT_TRUE( liveness::nextEvent( ev ) );
+    TEST_ASSERT_EQUAL_UINT8( 3, ev.id );
+    TEST_ASSERT_TRUE( ev.online );
+    TEST_ASSERT_UINT32_WITHIN( 2, back - (t0 + 40), ev.silent );
+    TEST_ASSERT_EQUAL( liveness::ONLINE, liveness::node( 3 ).state );
+    TEST_ASSERT_EQUAL( 3, numOffline() );
+
+    // node 2 is next, then node 3 with its new deadline
+    TEST_ASSERT_FALSE( liveness::nextEvent( ev ) );
+    at( lastDeadline + 5 );
+    TEST_ASSERT_TRUE( liveness::nextEvent( ev ) );
+    TEST_ASSERT_EQUAL_UINT8( 2, ev.id );
+    TEST_ASSERT_FALSE( liveness::nextEvent( ev ) );
+    int64_t deadline = back + liveness::node( 3 ).timeout;
+    at( deadline - 5 );
+    TEST_ASSERT_FALSE( liveness::nextEvent( ev ) );
+    at( deadline + 5 );
+    TEST_ASSERT_TRUE( liveness::nextEvent( ev ) );
+    TEST_ASSERT_EQUAL_UINT8( 3, ev.id );
+    TEST_ASSERT_FALSE( ev.online );
+    TEST_ASSERT_EQUAL( 5, numOffline() );
+}
+
+
+int main( int argc, char** argv )
+{
+    UNITY_BEGIN();
+    RUN_TEST( test_learning );
+    RUN_TEST( test_offline_in_deadline_order );
+    RUN_TEST( test_back_online );
+    return UNITY_END();
+}
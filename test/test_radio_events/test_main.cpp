@@ -0,0 +1,164 @@
+/**
+ * @file 		  test_main.cpp
+ *
+ * Project		: Home automation
+ * Author		: Bernd Waldmann
+ * Created		: 16-Oct-2026
+ * Tabsize		: 4
+ *
+ * This Revision: $Id$
+ */
+
+/*
+   Copyright (C) 2024 Bernd Waldmann
+
+   This Source Code Form is subject to the terms of the Mozilla Public License, v. 2.0.
+   If a copy of the MPL was not distributed with this file, You can obtain one at http://mozilla.org/MPL/2.0/
+
+   SPDX-License-Identifier: MPL-2.0
+*/
+
+/**
+ * @brief Throughput benchmark for the queue of radio events: the cost of what
+ * the MySensors hooks do per message (hash, push, profiler Scope), and of
+ * popping events in loop(). Also checks that a producer and a consumer on
+ * different threads lose or reorder nothing. Times are for the build host,
+ * not the ESP32.
+ *
+ * `pio test -e native -f test_radio_events`
+ */
+
+#include <unity.h>
+#include <stdio.h>
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include "dedup.h"
+#include "profile.h"
+#include "radio_events.h"
+
+const unsigned N = 1000000;     // events per test
+const unsigned BATCH = RADIO_QUEUE_SIZE / 2;
+
+static const uint8_t payload[] = "21.5";
+
+
+void setUp() {}
+void tearDown() {}
+
+
+/// what previewMessage() puts into a record, event `i` has time stamp `i`
+static radio::RadioEvent_t makeEvent( uint32_t i )
+{
+    radio::RadioEvent_t ev {};
+    ev.t = i;
+    ev.kind = radio::RECEIVED;
+    ev.sender = uint8_t(i);
+    ev.destination = 0;
+    ev.sensor = 1;
+    ev.type = 0;
+    ev.command = 1;
+    ev.length = sizeof payload - 1;
+    ev.hash = dedup::hash( ev.sender, ev.sensor, ev.command, ev.type, payload, ev.length );
+    return ev;
+}
+
+
+/// [ns] per event for hashing and pushing events in batches, popping each batch
+static void run( bool withScope, double& nsPush, double& nsPop )
+{
+    using clock = std::chrono::steady_clock;
+    clock::duration tPush {}, tPop {};
+    radio::RadioEvent_t ev;
+    uint32_t next = 0;
+    for (uint32_t i=0; i<N; i+=BATCH) {
+        auto t0 = clock::now();
+        for (uint32_t k=i; k<i+BATCH; k++) {
+            if (withScope) {
+                profile::Scope p( profile::PREVIEW );
+                radio::push( makeEvent(k) );
+            } else {
+                radio::push( makeEvent(k) );
+            }
+        }
+        auto t1 = clock::now();
+        while (radio::pop( ev )) {
+            TEST_ASSERT_EQUAL_UINT32( next, ev.t );
+            next++;
+        }
+        tPop += clock::now() - t1;
+        tPush += t1 - t0;
+    }
+    TEST_ASSERT_EQUAL_UINT32( N, next );
+    nsPush = std::chrono::duration<double,std::nano>( tPush ).count() / N;
+    nsPop = std::chrono::duration<double,std::nano>( tPop ).count() / N;
+}
+
+
+void test_hook_throughput()
+{
+    host::currentTask = (TaskHandle_t)(uintptr_t)0x100;
+    double nsPush, nsPop, nsPushScope, nsPopScope;
+    run( false, nsPush, nsPop );
+    run( true, nsPushScope, nsPopScope );
+    printf( "hash+push %.1f ns, with profiler Scope %.1f ns, pop %.1f ns per event\n",
+        nsPush, nsPushScope, nsPop );
+
+    radio::QueueStats_t qs;
+    radio::queueStats( qs );
+    TEST_ASSERT_EQUAL_UINT32( 2*N, qs.pushed );
+    TEST_ASSERT_EQUAL_UINT32( 0, qs.dropped );
+    TEST_ASSERT_EQUAL_UINT32( BATCH, qs.maxDepth );
+
+    profile::SectionStats_t st;
+    profile::read( profile::PREVIEW, st );
+    TEST_ASSERT_EQUAL_UINT32( N, st.n );
+}
+
+
+/// producer and consumer on different threads, like the MySensors task and loop()
+void test_concurrent_no_loss()
+{
+    radio::QueueStats_t before, after;
+    radio::queueStats( before );
+    std::atomic<bool> done { false };
+
+    std::thread producer( [&done]() {
+        host::currentTask = (TaskHandle_t)(uintptr_t)0x200;
+        for (uint32_t i=0; i<N; i++) {
+            // push() never waits, it drops the event if the ring is full: try again
+            while (!radio::push( makeEvent(i) )) std::this_thread::yield();
+        }
+        done = true;
+    });
+
+    radio::RadioEvent_t ev;
+    uint32_t next = 0;
+    for (bool last = false; !last; ) {
+        // events pushed before `done` was set may only show up after it
+        last = done;
+        bool any = false;
+        while (radio::pop( ev )) {
+            TEST_ASSERT_EQUAL_UINT32( next, ev.t );
+            TEST_ASSERT_EQUAL_UINT32( makeEvent(next).hash, ev.hash );
+            next++;
+            any = true;
+        }
+        // let the producer run, on a host with a single core
+        if (!any) std::this_thread::yield();
+    }
+    producer.join();
+
+    radio::queueStats( after );
+    TEST_ASSERT_EQUAL_UINT32( N, next );
+    TEST_ASSERT_EQUAL_UINT32( N, after.pushed - before.pushed );
+}
+
+
+int main( int argc, char** argv )
+{
+    UNITY_BEGIN();
+    RUN_TEST( test_hook_throughput );
+    RUN_TEST( test_concurrent_no_loss );
+    return UNITY_END();
+}
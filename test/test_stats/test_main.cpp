@@ -0,0 +1,196 @@
+/**
+ * @file 		  test_main.cpp
+ *
+ * Project		: Home automation
+ * Author		: Bernd Waldmann
+ * Created		: 16-Oct-2026
+ * Tabsize		: 4
+ *
+ * This Revision: $Id$
+ */
+
+/*
+   Copyright (C) 2024 Bernd Waldmann
+
+   This Source Code Form is subject to the terms of the Mozilla Public License, v. 2.0.
+   If a copy of the MPL was not distributed with this file, You can obtain one at http://mozilla.org/MPL/2.0/
+
+   SPDX-License-Identifier: MPL-2.0
+*/
+
+/**
+ * @brief Stress tests for the sharded statistics counters: writers and readers
+ * run concurrently on std::threads, each writer with a fixed task handle like
+ * the MySensors process task and the loop() task on the ESP32.
+ *
+ * Every `countSent()` adds 1 packet, ARC retries and 1 to histogram bin ARC,
+ * in one write section. So a consistent read always has retries == ARC * packets,
+ * histogram[ARC] == packets, and per-node retries == ARC * tx. A torn read, or
+ * a baseline from the middle of a write, breaks one of these.
+ *
+ * `pio test -e native`
+ */
+
+#include <unity.h>
+#include <atomic>
+#include <thread>
+#include "stats.h"
+
+const unsigned N = 200000;      // events per writer
+const unsigned ARC = 3;
+const uint8_t NODE[2] = { 10, 20 };
+
+static StatsSnapshot_t before, after, snap;
+
+/// result of checks done by reader threads, reported by the main thread
+static std::atomic<unsigned> reads, badReads, wrapped;
+static std::atomic<int> writersRunning;
+
+
+static void writer( unsigned i )
+{
+    host::currentTask = (TaskHandle_t)(uintptr_t)(0x100 + i);
+    for (unsigned k=0; k<N; k++) {
+        stats::countSent( NODE[i], ARC );
+        stats::countReceived( NODE[i] );
+        stats::countRxTx( stats::RX );
+    }
+    writersRunning--;
+}
+
+
+/// true if counters of a snapshot are consistent
+static bool consistent( const StatsSnapshot_t& s )
+{
+    const ArcStats_t& a = s.arcStats;
+    unsigned tx = 0;
+    for (uint8_t id : NODE) {
+        const NodeCounters_t& n = s.nodes[id];
+        if (n.retries != ARC * n.tx) return false;
+        tx += n.tx;
+    }
+    return a.retries == ARC * a.packets
+        && a.histogram[ARC] == a.packets
+        && tx == a.packets;
+}
+
+
+/// read all kinds of counters and check them, until writers are done
+static void reader( unsigned clearEvery )
+{
+    host::currentTask = (TaskHandle_t)(uintptr_t)0x200;
+    static thread_local StatsSnapshot_t s;
+    unsigned k = 0;
+    while (writersRunning > 0) {
+        if (clearEvery && ++k % clearEvery == 0) stats::clear( 0 );
+        stats::snapshot( s );
+        if (!consistent( s )) badReads++;
+        // after a clear, counters are differences, which wrap if the baseline is torn
+        if (s.arcStats.packets > 2*N || s.rxtxStats.nRx > 2*N) wrapped++;
+
+        RxTxStats_t rxtx;
+        ArcStats_t arc;
+        stats::globals( rxtx, arc );
+        if (arc.retries != ARC * arc.packets || arc.histogram[ARC] != arc.packets) badReads++;
+
+        NodeCounters_t n = stats::node( NODE[0] );
+        if (n.retries != ARC * n.tx) badReads++;
+        reads++;
+    }
+}
+
+
+static void run( unsigned nReaders, unsigned clearEvery )
+{
+    reads = badReads = wrapped = 0;
+    writersRunning = 2;
+    std::thread w0( writer, 0 ), w1( writer, 1 );
+    std::thread r[2];
+    for (unsigned i=0; i<nReaders; i++) r[i] = std::thread( reader, clearEvery );
+    w0.join();
+    w1.join();
+    for (unsigned i=0; i<nReaders; i++) r[i].join();
+}
+
+
+void setUp()
+{
+    stats::totals( before );
+}
+
+void tearDown() {}
+
+
+/// totals since startup must grow by exactly what the writers counted
+static void checkTotals()
+{
+    stats::totals( after );
+    TEST_ASSERT_EQUAL_UINT32( 2*N, after.arcStats.packets - before.arcStats.packets );
+    TEST_ASSERT_EQUAL_UINT32( 2*N*ARC, after.arcStats.retries - before.arcStats.retries );
+    TEST_ASSERT_EQUAL_UINT32( 2*N, after.rxtxStats.nRx - before.rxtxStats.nRx );
+    for (uint8_t id : NODE) {
+        TEST_ASSERT_EQUAL_UINT32( N, after.nodes[id].tx - before.nodes[id].tx );
+        TEST_ASSERT_EQUAL_UINT32( N, after.nodes[id].rx - before.nodes[id].rx );
+        TEST_ASSERT_TRUE( stats::isNodeSet( after.active, id ) );
+    }
+}
+
+
+void test_no_lost_increments()
+{
+    run( 0, 0 );
+    checkTotals();
+}
+
+
+void test_no_torn_reads()
+{
+    run( 1, 0 );
+    checkTotals();
+    TEST_ASSERT_GREATER_THAN( 0, reads.load() );
+    TEST_ASSERT_EQUAL_UINT32( 0, badReads.load() );
+}
+
+
+void test_clear_under_live_writers()
+{
+    stats::clear( 0 );      // so that counts since clear never exceed 2*N
+    run( 2, 8 );
+    checkTotals();
+    TEST_ASSERT_GREATER_THAN( 0, reads.load() );
+    TEST_ASSERT_EQUAL_UINT32( 0, badReads.load() );
+    TEST_ASSERT_EQUAL_UINT32( 0, wrapped.load() );
+
+    // with no writers, a clear makes everything 0
+    stats::clear( 0 );
+    stats::snapshot( snap );
+    TEST_ASSERT_EQUAL_UINT32( 0, snap.arcStats.packets );
+    TEST_ASSERT_EQUAL_UINT32( 0, snap.nodes[NODE[0]].tx );
+    TEST_ASSERT_TRUE( consistent( snap ) );
+}
+
+
+/// a node with only duplicates must survive a reboot, too
+void test_restore_all_counters()
+{
+    const uint8_t id = 30;
+    host::currentTask = (TaskHandle_t)(uintptr_t)0x100;    // same shard as writer 0
+    stats::clear( 0 );
+    stats::countDuplicate( id );
+    stats::snapshot( snap );
+    stats::clear( 0 );
+    stats::restore( snap, 1 );
+    TEST_ASSERT_EQUAL_UINT32( 1, stats::node( id ).dups );
+    TEST_ASSERT_EQUAL_UINT32( 0, stats::node( id ).rx );
+}
+
+
+int main( int argc, char** argv )
+{
+    UNITY_BEGIN();
+    RUN_TEST( test_no_lost_increments );
+    RUN_TEST( test_no_torn_reads );
+    RUN_TEST( test_clear_under_live_writers );
+    RUN_TEST( test_restore_all_counters );
+    return UNITY_END();
+}
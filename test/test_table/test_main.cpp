@@ -0,0 +1,118 @@
+/**
+ * @file 		  test_main.cpp
+ *
+ * Project		: Home automation
+ * Author		: Bernd Waldmann
+ * Created		: 16-Oct-2026
+ * Tabsize		: 4
+ *
+ * This Revision: $Id$
+ */
+
+/*
+   Copyright (C) 2024 Bernd Waldmann
+
+   This Source Code Form is subject to the terms of the Mozilla Public License, v. 2.0.
+   If a copy of the MPL was not distributed with this file, You can obtain one at http://mozilla.org/MPL/2.0/
+
+   SPDX-License-Identifier: MPL-2.0
+*/
+
+/**
+ * @brief The HTML table of per-node statistics is rendered into a fixed
+ * buffer without any heap allocation.
+ *
+ * `pio test -e native -f test_table`
+ */
+
+#include <unity.h>
+#include <string>
+#include "alloc_count.h"
+#include "stats.h"
+#include "liveness.h"
+#include "table.h"
+
+static StatsSnapshot_t snap;
+static char buf[4096];
+
+
+void setUp() {}
+void tearDown() {}
+
+
+/// the counting hooks work, otherwise a pass below means nothing
+void test_hooks_count()
+{
+    host::counting = true;
+    host::allocations = 0;
+    char* p = new char[16];
+    void* q = malloc( 16 );
+    host::counting = false;
+    delete[] p;
+    free( q );
+    TEST_ASSERT_EQUAL_UINT32( 2, host::allocations );
+}
+
+
+void test_table_without_allocations()
+{
+    for (int i=0; i<4; i++) stats::countReceived( 3 );
+    stats::countReceived( 12 );
+    stats::countReceived( 12 );
+    for (unsigned arc : { 0, 0, 1, 5 }) stats::countSent( 12, arc );
+    stats::countSent( 47, 0 );
+    liveness::seen( 12 );
+    stats::snapshot( snap );
+
+    // 1800 s since clear: 4 messages are 8/h; 4 sent with 6 retries are 40% success
+    TextWriter out( buf, sizeof buf );
+    host::counting = true;
+    host::allocations = 0;
+    table::render( out, snap, 1800 );
+    host::counting = false;
+
+    TEST_ASSERT_EQUAL_UINT32( 0, host::allocations );
+    TEST_ASSERT_TRUE( !out.overflowed() );
+    TEST_ASSERT_EQUAL_STRING(
+        "<table><tr><th> </th><th>&ensp;+0</th><th>&ensp;+1</th><th>&ensp;+2</th><th>&ensp;+3</th>"
+        "<th>&ensp;+4</th><th>&ensp;+5</th><th>&ensp;+6</th><th>&ensp;+7</th><th>&ensp;+8</th><th>&ensp;+9</th></tr>\n"
+        "<tr><th>0:</th><td id='n0'></td><td id='n1'></td><td id='n2'></td>"
+        "<td id='n3'><b>4</b>&ensp;<span class='mph'>8/h</span></td>"
+        "<td id='n4'></td><td id='n5'></td><td id='n6'></td><td id='n7'></td><td id='n8'></td><td id='n9'></td></tr>\n"
+        "<tr><th>10:</th><td id='n10'></td><td id='n11'></td>"
+        "<td id='n12'><b>2</b>&ensp;<span class='mph'>4/h</span><br/><span class='suc'>40%</span><br/><span class='arc'>0/5/5</span></td>"
+        "<td id='n13'></td><td id='n14'></td><td id='n15'></td><td id='n16'></td><td id='n17'></td><td id='n18'></td><td id='n19'></td></tr>\n"
+        "<tr><th>40:</th><td id='n40'></td><td id='n41'></td><td id='n42'></td><td id='n43'></td><td id='n44'></td><td id='n45'></td><td id='n46'></td>"
+        "<td id='n47'><br/><span class='suc'>100%</span><br/><span class='arc'>0/0/0</span></td>"
+        "<td id='n48'></td><td id='n49'></td></tr>\n"
+        "</table>",
+        out.c_str() );
+}
+
+
+/// the last row stops at node 255 and is padded with empty cells
+void test_last_row()
+{
+    stats::countReceived( 255 );
+    stats::snapshot( snap );
+
+    TextWriter out( buf, sizeof buf );
+    table::render( out, snap, 0 );
+
+    std::string expected = "<tr><th>250:</th>";
+    for (unsigned id=250; id<255; id++) expected += "<td id='n" + std::to_string(id) + "'></td>";
+    expected += "<td id='n255'><b>1</b></td><td></td><td></td><td></td><td></td></tr>\n</table>";
+    std::string html = out.c_str();
+    TEST_ASSERT_TRUE( html.size() > expected.size() );
+    TEST_ASSERT_EQUAL_STRING( expected.c_str(), html.c_str() + html.size() - expected.size() );
+}
+
+
+int main( int argc, char** argv )
+{
+    UNITY_BEGIN();
+    RUN_TEST( test_hooks_count );
+    RUN_TEST( test_table_without_allocations );
+    RUN_TEST( test_last_row );
+    return UNITY_END();
+}
@@ -0,0 +1,331 @@
+/**
+ * @file 		  test_main.cpp
+ *
+ * Project		: Home automation
+ * Author		: Bernd Waldmann
+ * Created		: 16-Oct-2026
+ * Tabsize		: 4
+ *
+ * This Revision: $Id$
+ */
+
+/*
+   Copyright (C) 2024 Bernd Waldmann
+
+   This Source Code Form is subject to the terms of the Mozilla Public License, v. 2.0.
+   If a copy of the MPL was not distributed with this file, You can obtain one at http://mozilla.org/MPL/2.0/
+
+   SPDX-License-Identifier: MPL-2.0
+*/
+
+/**
+ * @brief Benchmarks of the page renderer: the old `process()`, which scans a
+ * String copy of the template with indexOf() and substring(), against the
+ * pre-tokenized template of html_template.h. Both render the same page as
+ * index_html in main.cpp (repeater version), with fixed values for the
+ * keywords and a 6 KB table. Heap allocations and time per page are printed.
+ *
+ * Keyword dispatch is measured on its own: the old chain of String compares
+ * against a `switch` on the keyword id resolved by the tokenizer, for all
+ * keywords of the page. Times are for the build host, not the ESP32.
+ *
+ * `pio test -e native -f test_template`
+ */
+
+#include <unity.h>
+#include <stdio.h>
+#include <chrono>
+#include <Arduino.h>
+#include "alloc_count.h"
+#include "html_template.h"
+
+const unsigned REPEAT = 1000;
+
+constexpr char page[] = R"rawliteral(
+<!DOCTYPE HTML><html>
+<head>
+  <title>%TITLE%</title>
+  <style>
+    body { background-color: #cccccc; font-family: Arial, Helvetica, Sans-Serif; Color: #000088; line-height: 1.1; }
+    table { border-collapse: collapse; }
+    td { text-align: right; border: 1px solid #777777; padding: 4px; }
+    button { margin: 5px; padding:10px; min-height:20px; min-width: 80px; float:left; }
+    .mph { color: #606060; font-size:smaller; }
+    .suc { color: #fc03fc; font-size:smaller; }
+  </style>
+</head>
+<body>
+  <h2>%TITLE%</h2>
+  <p>
+    IP:<b>%IPADDR%</b>&emsp;
+    Name:<b>%HOSTNAME%</b>&emsp;
+    Channel:<b>%CHANNEL%</b>&emsp;
+    Power:<b>%POWER%</b>&emsp;
+    Node:<b>%NODEID%</b>&emsp;
+    Parent:<b>%PARENT%</b>&emsp;
+  </p>
+  <p>
+    ARC <b>%SUCCESS%</b>%% success, <b>%PACKETS%</b> packets, <b>%RETRIES%</b> retries.&emsp;
+  </p>
+  <p>
+    Node rx:<b>%NRX%</b>&ensp;tx:<b>%NTX%</b>&ensp;err:<b>%NERR%</b> (<b>%ERROR_RATE%</b>%%)&emsp;
+  </p>
+  <p>
+    since %LASTCLEAR% (%ELAPSED%)&emsp;
+    time is now %NOW%
+  </p>
+  <p>%TABLE%</p>
+  <form action="/clear"><button type="submit">Clear</button></form>
+  <form action="/reboot"><button type="submit">Restart</button></form>
+</body>
+</html>
+)rawliteral";
+
+/// the keywords of main.cpp
+#define PAGE_KEYWORDS(X) \
+    X(IPADDR) X(HOSTNAME) X(NODEID) X(VERSION) X(PARENT) \
+    X(POWER) X(CHANNEL) \
+    X(NRX) X(NTX) X(NERR) X(NGWRX) X(NGWTX) X(ERROR_RATE) \
+    X(PACKETS) X(RETRIES) X(SUCCESS) \
+    X(TITLE) X(NOW) X(LASTCLEAR) X(ELAPSED) X(TABLE)
+
+enum PageKeyword : uint8_t {
+#define X(name) KW_##name,
+    PAGE_KEYWORDS(X)
+#undef X
+    NUM_KEYWORDS
+};
+
+constexpr const char* page_keywords[] = {
+#define X(name) #name,
+    PAGE_KEYWORDS(X)
+#undef X
+};
+
+static_assert( tmpl::hasOnlyKeywords(page,page_keywords), "unknown %KEYWORD% in page" );
+
+constexpr auto page_tokens = tmpl::tokenize<tmpl::countTokens(page)>(page,page_keywords);
+
+/// stands in for the output of make_table()
+static char table[6000];
+
+
+void setUp() {}
+void tearDown() {}
+
+
+//----- the old renderer, as it was in main.cpp
+
+static String oldProcessor( const String& var )
+{
+    if (var.length()==0) return "%";
+    if (var=="IPADDR") return "192.168.161.71";
+    if (var=="HOSTNAME") return "ESP32-6D393B";
+    if (var=="NODEID") return String(25);
+    if (var=="VERSION") return "1684";
+    if (var=="PARENT") return String(0);
+    if (var=="POWER") return String(2);
+    if (var=="CHANNEL") return String(76);
+    if (var=="NRX") return String(123456u);
+    if (var=="NTX") return String(23456u);
+    if (var=="NERR") return String(12u);
+    if (var=="NGWRX") return String(0u);
+    if (var=="NGWTX") return String(0u);
+    if (var=="ERROR_RATE") return String(0u);
+    if (var=="PACKETS") return String(23456u);
+    if (var=="RETRIES") return String(3456u);
+    if (var=="SUCCESS") return String(87u);
+    if (var=="TITLE") return "MySensors repeater";
+    if (var=="NOW") return "16.10.2026 12:34:56";
+    if (var=="LASTCLEAR") return "15.10.2026 08:00:00";
+    if (var=="ELAPSED") return "1d 4h 34m";
+    if (var=="TABLE") return table;
+    return String();
+}
+
+static String oldProcess( const String& tpl )
+{
+    String res = "";
+    int p1,p2;
+
+    p1 = tpl.indexOf(CHAR_BEGIN_VAR);
+    p2 = 0;
+    while (p1 != -1) {
+        res += tpl.substring(p2,p1);
+        p2 = tpl.indexOf(CHAR_END_VAR,p1+1);
+        if (p2 != -1) {
+            res += oldProcessor( tpl.substring(p1+1,p2) );
+        }
+        p1 = tpl.indexOf(CHAR_BEGIN_VAR,p2+1);
+        p2++;
+    }
+    res += tpl.substring(p2);
+    return res;
+}
+
+
+//----- the new renderer, like main.cpp but into a String as before
+
+static void processor( PageKeyword kw, String& out )
+{
+    switch (kw) {
+    case KW_IPADDR:     out += "192.168.161.71"; break;
+    case KW_HOSTNAME:   out += "ESP32-6D393B"; break;
+    case KW_NODEID:     out += 25; break;
+    case KW_VERSION:    out += "1684"; break;
+    case KW_PARENT:     out += 0; break;
+    case KW_POWER:      out += 2; break;
+    case KW_CHANNEL:    out += 76; break;
+    case KW_NRX:        out += 123456u; break;
+    case KW_NTX:        out += 23456u; break;
+    case KW_NERR:       out += 12u; break;
+    case KW_NGWRX:      out += 0u; break;
+    case KW_NGWTX:      out += 0u; break;
+    case KW_ERROR_RATE: out += 0u; break;
+    case KW_PACKETS:    out += 23456u; break;
+    case KW_RETRIES:    out += 3456u; break;
+    case KW_SUCCESS:    out += 87u; break;
+    case KW_TITLE:      out += "MySensors repeater"; break;
+    case KW_NOW:        out += "16.10.2026 12:34:56"; break;
+    case KW_LASTCLEAR:  out += "15.10.2026 08:00:00"; break;
+    case KW_ELAPSED:    out += "1d 4h 34m"; break;
+    case KW_TABLE:      out += table; break;
+    default:            break;
+    }
+}
+
+template<size_t NT>
+static String process( const char* tpl, const tmpl::TokenTable<NT>& tokens )
+{
+    String res;
+    res.reserve( sizeof(page) + sizeof(table) );
+    for (const tmpl::Token& tok : tokens) {
+        if (tok.kind == tmpl::LITERAL)
+            res.concat( tpl + tok.offset, tok.length );
+        else
+            processor( PageKeyword(tok.id), res );
+    }
+    return res;
+}
+
+
+//----- measurement
+
+/// allocations per call of `fn`, and [us] per call
+struct Cost {
+    unsigned allocations;
+    double us;
+};
+
+template<typename Fn>
+static Cost measure( Fn fn )
+{
+    host::allocations = 0;
+    host::counting = true;
+    fn();
+    host::counting = false;
+    Cost c { host::allocations, 0 };
+
+    auto t0 = std::chrono::steady_clock::now();
+    for (unsigned i=0; i<REPEAT; i++) fn();
+    auto t1 = std::chrono::steady_clock::now();
+    c.us = std::chrono::duration<double,std::micro>( t1 - t0 ).count() / REPEAT;
+    return c;
+}
+
+
+void test_same_output()
+{
+    String a = oldProcess( page );
+    String b = process( page, page_tokens );
+    TEST_ASSERT_EQUAL_STRING( a.c_str(), b.c_str() );
+}
+
+
+void test_render_cost()
+{
+    unsigned len = 0;
+    Cost before = measure( [&]() { len += oldProcess( page ).length(); } );
+    Cost after = measure( [&]() { len += process( page, page_tokens ).length(); } );
+    printf( "old process(): %u allocations, %.1f us per page\n", before.allocations, before.us );
+    printf( "tokenized:     %u allocations, %.1f us per page\n", after.allocations, after.us );
+    TEST_ASSERT_GREATER_THAN( 0, len );
+    // the only allocation is the output buffer, which is reserved once
+    TEST_ASSERT_EQUAL_UINT32( 1, after.allocations );
+}
+
+
+//----- keyword dispatch only
+
+/// replacement text of each keyword, as returned by both dispatchers
+static const char* values[NUM_KEYWORDS];
+
+static const char* oldDispatch( const String& var )
+{
+    if (var=="IPADDR") return values[KW_IPADDR];
+    if (var=="HOSTNAME") return values[KW_HOSTNAME];
+    if (var=="NODEID") return values[KW_NODEID];
+    if (var=="VERSION") return values[KW_VERSION];
+    if (var=="PARENT") return values[KW_PARENT];
+    if (var=="POWER") return values[KW_POWER];
+    if (var=="CHANNEL") return values[KW_CHANNEL];
+    if (var=="NRX") return values[KW_NRX];
+    if (var=="NTX") return values[KW_NTX];
+    if (var=="NERR") return values[KW_NERR];
+    if (var=="NGWRX") return values[KW_NGWRX];
+    if (var=="NGWTX") return values[KW_NGWTX];
+    if (var=="ERROR_RATE") return values[KW_ERROR_RATE];
+    if (var=="PACKETS") return values[KW_PACKETS];
+    if (var=="RETRIES") return values[KW_RETRIES];
+    if (var=="SUCCESS") return values[KW_SUCCESS];
+    if (var=="TITLE") return values[KW_TITLE];
+    if (var=="NOW") return values[KW_NOW];
+    if (var=="LASTCLEAR") return values[KW_LASTCLEAR];
+    if (var=="ELAPSED") return values[KW_ELAPSED];
+    if (var=="TABLE") return values[KW_TABLE];
+    return nullptr;
+}
+
+static const char* dispatch( PageKeyword kw )
+{
+    switch (kw) {
+#define X(name) case KW_##name: return values[KW_##name];
+    PAGE_KEYWORDS(X)
+#undef X
+    default: return nullptr;
+    }
+}
+
+
+void test_keyword_dispatch()
+{
+    for (unsigned k=0; k<NUM_KEYWORDS; k++) values[k] = page_keywords[k];
+    // the old code compared substrings of the template, so prepare those once
+    static String vars[NUM_KEYWORDS];
+    for (unsigned k=0; k<NUM_KEYWORDS; k++) vars[k] = page_keywords[k];
+
+    const unsigned N = NUM_KEYWORDS * REPEAT * 10;
+    volatile uintptr_t sink = 0;
+    auto t0 = std::chrono::steady_clock::now();
+    for (unsigned i=0; i<N; i++) sink = sink + uintptr_t( oldDispatch( vars[i % NUM_KEYWORDS] ) );
+    auto t1 = std::chrono::steady_clock::now();
+    for (unsigned i=0; i<N; i++) sink = sink + uintptr_t( dispatch( PageKeyword(i % NUM_KEYWORDS) ) );
+    auto t2 = std::chrono::steady_clock::now();
+    printf( "%u keywords: String compares %.1f ns, switch %.1f ns per keyword\n", unsigned(NUM_KEYWORDS),
+        std::chrono::duration<double,std::nano>( t1 - t0 ).count() / N,
+        std::chrono::duration<double,std::nano>( t2 - t1 ).count() / N );
+
+    for (unsigned k=0; k<NUM_KEYWORDS; k++)
+        TEST_ASSERT_TRUE( oldDispatch( vars[k] ) == dispatch( PageKeyword(k) ) );
+}
+
+
+int main( int argc, char** argv )
+{
+    memset( table, 'x', sizeof(table) - 1 );
+    UNITY_BEGIN();
+    RUN_TEST( test_same_output );
+    RUN_TEST( test_render_cost );
+    RUN_TEST( test_keyword_dispatch );
+    return UNITY_END();
+}
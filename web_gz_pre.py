@@ -0,0 +1,50 @@
+#
+# pre-build script to gzip the static web UI shell and make it available 
+# as a byte array in flash, for serving with Content-Encoding: gzip
+#
+# Copyright (C)2026 Bernd Waldmann
+#
+
+import gzip,os,zlib
+
+try:
+    Import("env")
+    PROJECT_DIR = env.subst("$PROJECT_DIR")
+except NameError:       # run stand-alone, outside of PlatformIO
+    PROJECT_DIR = os.path.dirname(os.path.abspath(__file__))
+
+SOURCE_FILE = os.path.join(PROJECT_DIR, "web", "index.html")
+HEADER_FILE = os.path.join(PROJECT_DIR, "include", "index_html_gz.h")
+
+with open(SOURCE_FILE, 'rb') as FILE:
+    html = FILE.read()
+
+# mtime=0 makes the output reproducible, so the header only changes if the source does
+data = gzip.compress(html, compresslevel=9, mtime=0)
+crc = zlib.crc32(html) & 0xFFFFFFFF
+
+print("Compressed %s: %u -> %u bytes" % (SOURCE_FILE, len(html), len(data)))
+
+lines = []
+for i in range(0, len(data), 16):
+    lines.append("    " + "".join("0x%02X," % b for b in data[i:i+16]))
+
+HEADER = """
+    // AUTO GENERATED FILE, DO NOT EDIT
+    // gzip-compressed web/index.html, made by web_gz_pre.py
+    #ifndef INDEX_HTML_GZ_H
+    #define INDEX_HTML_GZ_H
+    #define INDEX_HTML_GZ_ETAG "\\"{:08x}\\""
+    const uint8_t index_html_gz[{}] PROGMEM = {{
+{}
+    }};
+    #endif
+    """.format(crc, len(data), "\n".join(lines))
+
+old = None
+if os.path.exists(HEADER_FILE):
+    with open(HEADER_FILE, 'r') as FILE:
+        old = FILE.read()
+if old != HEADER:
+    with open(HEADER_FILE, 'w+') as FILE:
+        FILE.write(HEADER)